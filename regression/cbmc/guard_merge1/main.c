@@ -0,0 +1,52 @@
+_Bool nondet_bool();
+
+int main()
+{
+  _Bool c1=nondet_bool(), c2=nondet_bool(), c3=nondet_bool();
+  int x=0, y=0, z=0;
+
+  // diamond
+  if(c1)
+    x=1;
+  else
+    x=2;
+
+  // if without an else, with a diamond inside
+  if(c2)
+  {
+    if(c3)
+      y=1;
+    else
+      y=2;
+
+    z=1;
+  }
+
+  if(c3)
+    z+=10;
+
+  assert(c1 ? x==1 : x==2);
+  assert(c2 ? y==(c3?1:2) : y==0);
+  assert(z==(c2?1:0)+(c3?10:0));
+
+  // assertions under merged guards
+  if(x==1)
+    assert(c1);
+
+  if(y!=0)
+    assert(c2);
+
+  // the paths that return do not reach the rest
+  if(c1 && c2)
+    return 0;
+
+  assert(!c1 || !c2);
+
+  if(x==2)
+    return 0;
+
+  assert(c1 && !c2);
+  assert(z<=10);
+
+  return 0;
+}
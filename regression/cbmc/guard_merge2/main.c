@@ -0,0 +1,25 @@
+_Bool nondet_bool();
+
+int main()
+{
+  _Bool c1=nondet_bool(), c2=nondet_bool();
+  int x=0, y=0;
+
+  // diamond
+  if(c1)
+    x=1;
+  else
+    x=2;
+
+  // if without an else
+  if(c2)
+    y=1;
+
+  if(c1 && !c2)
+    return 0;
+
+  // fails only for !c1 && c2
+  assert(x==1 || y==0);
+
+  return 0;
+}
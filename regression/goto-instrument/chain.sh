@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# Usage: chain.sh [goto-instrument options] test_file.c
+
+src=../../../src
+goto_cc=$src/goto-cc/goto-cc
+goto_instrument=$src/goto-instrument/goto-instrument
+
+name=${*:$#}
+name=${name%.c}
+args=${*:1:$#-1}
+
+$goto_cc -o $name.gb $name.c || exit $?
+$goto_instrument $args $name.gb
@@ -0,0 +1,13 @@
+int main()
+{
+  int a=0, b=5, c;
+
+  if(c)
+  {
+    a=1;
+    b=7;
+  }
+
+  // each variable is joined with itself
+  return a+b;
+}
@@ -0,0 +1,19 @@
+void f(int n)
+{
+  int r=0;
+
+  if(n>0)
+  {
+    f(n-1);
+    r=2;
+  }
+
+  // reached after the recursive call returns
+  n=r;
+}
+
+int main()
+{
+  f(3);
+  return 0;
+}
@@ -8,6 +8,8 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <cassert>
 #include <memory>
+#include <ostream>
+#include <algorithm>
 
 #include <util/std_expr.h>
 #include <util/std_code.h>
@@ -85,6 +87,32 @@ void ai_baset::output(
 
 /*******************************************************************\
 
+Function: ai_baset::output_statistics
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ai_baset::output_statistics(std::ostream &out) const
+{
+  out << "Fixedpoint: " << statistics.visits << " visits, "
+      << statistics.updates << " updates, "
+      << statistics.widenings << " widenings, "
+      << statistics.narrowings << " narrowings\n";
+  out << "Widening points: " << statistics.widening_points
+      << ", at most " << statistics.max_updates
+      << " updates per location\n";
+  out << "Functions: " << statistics.function_analyses << " analyzed, "
+      << statistics.function_reanalyses << " re-analyzed from the entry, "
+      << statistics.summary_hits << " calls answered by the summary\n";
+}
+
+/*******************************************************************\
+
 Function: ai_baset::initialize
 
   Inputs:
@@ -116,6 +144,9 @@ void ai_baset::initialize(const goto_programt &goto_program)
 {
   forall_goto_program_instructions(i_it, goto_program)
     get_state(i_it);
+
+  if(!goto_program.instructions.empty())
+    get_state(goto_program.instructions.begin()).make_entry();
 }
 
 /*******************************************************************\
@@ -182,13 +213,38 @@ bool ai_baset::fixedpoint(
 {
   if(goto_program.instructions.empty())
     return false;
+
+  if(priority_map.find(goto_program.instructions.begin())==
+     priority_map.end())
+    compute_iteration_order(goto_program);
   
   working_sett working_set;
 
   // We will put all locations at least once into the working set.
   forall_goto_program_instructions(i_it, goto_program)
     put_in_working_set(working_set, i_it);
-    
+
+  return fixedpoint(working_set, goto_program, goto_functions, ns);
+}
+
+/*******************************************************************\
+
+Function: ai_baset::fixedpoint
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool ai_baset::fixedpoint(
+  working_sett &working_set,
+  const goto_programt &goto_program,
+  const goto_functionst &goto_functions,
+  const namespacet &ns)
+{
   bool new_data=false;
 
   while(!working_set.empty())
@@ -204,6 +260,266 @@ bool ai_baset::fixedpoint(
 
 /*******************************************************************\
 
+Function: ai_baset::compute_iteration_order
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: number the locations in reverse post-order of
+          a depth-first traversal, and record the targets
+          of retreating edges as widening points
+
+\*******************************************************************/
+
+void ai_baset::compute_iteration_order(const goto_programt &goto_program)
+{
+  struct framet
+  {
+    locationt l;
+    goto_programt::const_targetst successors;
+    goto_programt::const_targetst::const_iterator next;
+  };
+
+  // true = on the stack, false = finished
+  typedef hash_map_cont<locationt, bool, const_target_hash> dfs_statet;
+  dfs_statet dfs_state;
+
+  std::vector<locationt> post_order;
+  post_order.reserve(goto_program.instructions.size());
+
+  // a list, as references to the top frame must remain valid
+  std::list<framet> stack;
+
+  // the first instruction is the root; unreachable
+  // instructions are numbered after the reachable ones
+  forall_goto_program_instructions(i_it, goto_program)
+  {
+    if(dfs_state.find(i_it)!=dfs_state.end())
+      continue;
+
+    stack.push_back(framet());
+    stack.back().l=i_it;
+    goto_program.get_successors(i_it, stack.back().successors);
+    stack.back().next=stack.back().successors.begin();
+    dfs_state[i_it]=true;
+
+    while(!stack.empty())
+    {
+      framet &top=stack.back();
+
+      if(top.next==top.successors.end())
+      {
+        dfs_state[top.l]=false;
+        post_order.push_back(top.l);
+        stack.pop_back();
+        continue;
+      }
+
+      locationt to=*top.next;
+      top.next++;
+
+      if(to==goto_program.instructions.end())
+        continue;
+
+      dfs_statet::const_iterator s_it=dfs_state.find(to);
+
+      if(s_it==dfs_state.end())
+      {
+        stack.push_back(framet());
+        stack.back().l=to;
+        goto_program.get_successors(to, stack.back().successors);
+        stack.back().next=stack.back().successors.begin();
+        dfs_state[to]=true;
+      }
+      else if(s_it->second)
+      {
+        // retreating edge
+        if(widening_points.insert(to).second)
+          statistics.widening_points++;
+      }
+    }
+  }
+
+  unsigned nr=0;
+
+  for(std::vector<locationt>::const_reverse_iterator
+      it=post_order.rbegin();
+      it!=post_order.rend();
+      it++)
+    priority_map[*it]=nr++;
+}
+
+/*******************************************************************\
+
+Function: ai_baset::get_priority
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+unsigned ai_baset::get_priority(locationt l) const
+{
+  priority_mapt::const_iterator it=priority_map.find(l);
+  assert(it!=priority_map.end());
+  return it->second;
+}
+
+/*******************************************************************\
+
+Function: ai_baset::merge_or_widen
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: join 'src' into the state at 'to', using widening
+          once a widening point has been updated often
+          enough
+
+\*******************************************************************/
+
+bool ai_baset::merge_or_widen(
+  const statet &src,
+  locationt from,
+  locationt to)
+{
+  unsigned &updates=update_count[to];
+
+  bool use_widening=
+    updates>=widening_delay &&
+    widening_points.find(to)!=widening_points.end();
+
+  bool result=
+    use_widening?widen(src, from, to):merge(src, from, to);
+
+  if(result)
+  {
+    updates++;
+    statistics.updates++;
+    if(use_widening) statistics.widenings++;
+    statistics.max_updates=std::max(statistics.max_updates,
+                                    (std::size_t)updates);
+  }
+
+  return result;
+}
+
+/*******************************************************************\
+
+Function: ai_baset::narrowing
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: descending iteration: refine each state using the
+          join of the states on its incoming edges; states
+          that receive edges from other functions are kept
+
+\*******************************************************************/
+
+void ai_baset::narrowing(
+  const goto_programt &goto_program,
+  const goto_functionst &goto_functions,
+  const namespacet &ns)
+{
+  if(narrowing_rounds==0 || goto_program.instructions.empty())
+    return;
+
+  if(priority_map.find(goto_program.instructions.begin())==
+     priority_map.end())
+    compute_iteration_order(goto_program);
+
+  typedef std::map<unsigned, locationt> orderedt;
+  orderedt ordered;
+  
+  typedef hash_map_cont<locationt, goto_programt::const_targetst,
+                        const_target_hash> predecessorst;
+  predecessorst predecessors;
+
+  forall_goto_program_instructions(i_it, goto_program)
+  {
+    ordered[get_priority(i_it)]=i_it;
+
+    goto_programt::const_targetst successors;
+    goto_program.get_successors(i_it, successors);
+
+    for(goto_programt::const_targetst::const_iterator
+        it=successors.begin();
+        it!=successors.end();
+        it++)
+      if(*it!=goto_program.instructions.end())
+        predecessors[*it].push_back(i_it);
+  }
+
+  for(unsigned round=0; round<narrowing_rounds; round++)
+  {
+    bool new_data=false;
+
+    for(orderedt::const_iterator o_it=ordered.begin();
+        o_it!=ordered.end();
+        o_it++)
+    {
+      locationt l=o_it->second;
+
+      // the entry state comes from the call sites
+      if(l==goto_program.instructions.begin())
+        continue;
+
+      const goto_programt::const_targetst &preds=predecessors[l];
+
+      if(preds.empty())
+        continue;
+
+      std::unique_ptr<statet> joined;
+      bool interprocedural=false;
+
+      for(goto_programt::const_targetst::const_iterator
+          p_it=preds.begin();
+          p_it!=preds.end();
+          p_it++)
+      {
+        locationt from=*p_it;
+
+        if(from->is_function_call() &&
+           !goto_functions.function_map.empty())
+        {
+          interprocedural=true;
+          break;
+        }
+
+        std::unique_ptr<statet> tmp_state(
+          make_temporary_state(get_state(from)));
+        tmp_state->transform(from, l, *this, ns);
+
+        if(joined.get()==0)
+          joined.swap(tmp_state);
+        else
+          merge_temporary(*joined, *tmp_state, from, l);
+      }
+
+      if(interprocedural)
+        continue;
+
+      if(narrow(*joined, l))
+      {
+        new_data=true;
+        statistics.narrowings++;
+      }
+    }
+
+    if(!new_data)
+      break;
+  }
+}
+
+/*******************************************************************\
+
 Function: ai_baset::visit
 
   Inputs:
@@ -223,6 +539,8 @@ bool ai_baset::visit(
 {
   bool new_data=false;
 
+  statistics.visits++;
+
   statet &current=get_state(l);
 
   goto_programt::const_targetst successors;
@@ -267,7 +585,7 @@ bool ai_baset::visit(
 
       new_values.transform(l, to_l, *this, ns);
     
-      if(merge(new_values, l, to_l))
+      if(merge_or_widen(new_values, l, to_l))
         have_new_values=true;
     }
   
@@ -311,7 +629,7 @@ bool ai_baset::do_function_call(
     std::unique_ptr<statet> tmp_state(make_temporary_state(get_state(l_call)));
     tmp_state->transform(l_call, l_return, *this, ns);
 
-    return merge(*tmp_state, l_call, l_return);
+    return merge_or_widen(*tmp_state, l_call, l_return);
   }
     
   assert(!goto_function.body.instructions.empty());
@@ -329,23 +647,28 @@ bool ai_baset::do_function_call(
     bool new_data=false;
 
     // merge the new stuff
-    if(merge(*tmp_state, l_call, l_begin))
+    if(merge_or_widen(*tmp_state, l_call, l_begin))
       new_data=true;
 
     // do each function at least once
-    if(functions_done.find(f_it->first)==
-       functions_done.end())
-    {
-      new_data=true;
-      functions_done.insert(f_it->first);
-    }
-
-    // do we need to do the fixedpoint of the body?
-    if(new_data)
+    if(functions_done.insert(f_it->first).second)
     {
       // also do the fixedpoint of the body via a recursive call
+      statistics.function_analyses++;
       fixedpoint(goto_function.body, goto_functions, ns);
     }
+    else if(new_data)
+    {
+      // The rest of the body is at a fixedpoint already,
+      // hence only the changes at the entry need to be
+      // propagated.
+      statistics.function_reanalyses++;
+      working_sett working_set;
+      put_in_working_set(working_set, l_begin);
+      fixedpoint(working_set, goto_function.body, goto_functions, ns);
+    }
+    else
+      statistics.summary_hits++;
   }
 
   {
@@ -360,7 +683,7 @@ bool ai_baset::do_function_call(
     // Propagate those -- not exceedingly precise, this is,
     // as still it contains all the state from the
     // call site
-    return merge(*tmp_state, l_end, l_return);
+    return merge_or_widen(*tmp_state, l_end, l_return);
   }
 }    
 
@@ -393,7 +716,20 @@ bool ai_baset::do_function_call_rec(
     
     if(recursion_set.find(identifier)!=recursion_set.end())
     {
-      // recursion detected!
+      // recursion detected! sequential_fixedpoint feeds the
+      // return edge once nothing is blocked; the entry and the
+      // return may then change any number of times
+      if(recursive_calls.insert(l_call).second)
+      {
+        const goto_programt &body=
+          goto_functions.function_map.find(identifier)->second.body;
+
+        if(widening_points.insert(body.instructions.begin()).second)
+          statistics.widening_points++;
+        if(widening_points.insert(l_return).second)
+          statistics.widening_points++;
+      }
+
       return new_data;
     }
     else
@@ -476,13 +812,44 @@ void ai_baset::sequential_fixedpoint(
   const goto_functionst &goto_functions,
   const namespacet &ns)
 {
-  // do each function at least once
+  // do each function at least once, unless it has been
+  // reached via a call already
+
+  for(goto_functionst::function_mapt::const_iterator
+      it=goto_functions.function_map.begin();
+      it!=goto_functions.function_map.end();
+      it++)
+    if(functions_done.insert(it->first).second)
+    {
+      statistics.function_analyses++;
+      fixedpoint(it->second.body, goto_functions, ns);
+    }
+
+  // A recursive call reached from inside its callee did not
+  // feed its return edge.  Redo all functions from the top,
+  // where no call is blocked, until no state changes.
+  if(!recursive_calls.empty())
+  {
+    std::size_t updates;
+
+    do
+    {
+      updates=statistics.updates;
+
+      for(goto_functionst::function_mapt::const_iterator
+          it=goto_functions.function_map.begin();
+          it!=goto_functions.function_map.end();
+          it++)
+        fixedpoint(it->second.body, goto_functions, ns);
+    }
+    while(statistics.updates!=updates);
+  }
 
   for(goto_functionst::function_mapt::const_iterator
       it=goto_functions.function_map.begin();
       it!=goto_functions.function_map.end();
       it++)
-    fixedpoint(it->second.body, goto_functions, ns);
+    narrowing(it->second.body, goto_functions, ns);
 }
 
 /*******************************************************************\
@@ -54,6 +54,12 @@ public:
     const namespacet &ns) const
   {
   }
+
+  // The state at the beginning of each function;
+  // overload this if the constructor produces 'bottom'.
+  virtual void make_entry()
+  {
+  }
   
   // also add
   //
@@ -61,6 +67,32 @@ public:
   //
   // This computes the join between "this" and "b".
   // Return true if "this" has changed.
+
+  // Domains of infinite height should also add
+  //
+  //   bool widen(const T &b, locationt from, locationt to);
+  //
+  // which is used instead of 'merge' at widening points,
+  // and may add
+  //
+  //   bool narrow(const T &b, locationt to);
+  //
+  // which refines "this" using "b", the join of the states
+  // on all incoming edges, once the fixedpoint is reached.
+  // Return true if "this" has changed.
+
+  // The defaults below are for domains of finite height.
+  template<typename T>
+  bool widen(const T &b, locationt from, locationt to)
+  {
+    return static_cast<T &>(*this).merge(b, from, to);
+  }
+
+  template<typename T>
+  bool narrow(const T &b, locationt to)
+  {
+    return false;
+  }
 };
 
 // don't use me -- I am just a base class
@@ -71,7 +103,9 @@ public:
   typedef ai_domain_baset statet;
   typedef goto_programt::const_targett locationt;
 
-  ai_baset()
+  ai_baset():
+    widening_delay(2),
+    narrowing_rounds(0)
   {
   }
   
@@ -86,6 +120,7 @@ public:
     goto_functionst goto_functions;
     initialize(goto_program);
     fixedpoint(goto_program, goto_functions, ns);
+    narrowing(goto_program, goto_functions, ns);
   }
     
   inline void operator()(
@@ -103,11 +138,55 @@ public:
     goto_functionst goto_functions;
     initialize(goto_function);
     fixedpoint(goto_function.body, goto_functions, ns);
+    narrowing(goto_function.body, goto_functions, ns);
   }
 
   virtual void clear()
   {
+    priority_map.clear();
+    widening_points.clear();
+    update_count.clear();
+    functions_done.clear();
+    recursive_calls.clear();
+    statistics=statisticst();
   }
+
+  // number of updates of a state at a widening point
+  // before widening is used instead of merging
+  inline void set_widening_delay(unsigned _widening_delay)
+  {
+    widening_delay=_widening_delay;
+  }
+
+  // number of descending iterations once the fixedpoint
+  // is reached, 0 disables narrowing
+  inline void set_narrowing_rounds(unsigned _narrowing_rounds)
+  {
+    narrowing_rounds=_narrowing_rounds;
+  }
+
+  struct statisticst
+  {
+    std::size_t visits, updates, widenings, narrowings;
+    std::size_t widening_points, max_updates;
+    // function bodies analyzed from scratch, re-analyzed
+    // from their entry, and calls answered by the summary
+    std::size_t function_analyses, function_reanalyses, summary_hits;
+
+    statisticst():
+      visits(0), updates(0), widenings(0), narrowings(0),
+      widening_points(0), max_updates(0),
+      function_analyses(0), function_reanalyses(0), summary_hits(0)
+    {
+    }
+  };
+
+  inline const statisticst &get_statistics() const
+  {
+    return statistics;
+  }
+
+  void output_statistics(std::ostream &out) const;
   
   virtual void output(
     const namespacet &ns,
@@ -142,7 +221,10 @@ protected:
     const irep_idt &identifier,
     std::ostream &out) const;
 
-  // the work-queue is sorted by location number
+  // The work-queue is sorted by the reverse post-order
+  // number of the location, which is computed once per
+  // goto program; the targets of retreating edges of
+  // the depth-first traversal are the widening points.
   typedef std::map<unsigned, locationt> working_sett;
   
   locationt get_next(working_sett &working_set);
@@ -152,14 +234,47 @@ protected:
     locationt l)
   {
     working_set.insert(
-      std::pair<unsigned, locationt>(l->location_number, l));
+      std::pair<unsigned, locationt>(get_priority(l), l));
   }
+
+  typedef hash_map_cont<locationt, unsigned, const_target_hash>
+    priority_mapt;
+  priority_mapt priority_map;
+
+  typedef hash_set_cont<locationt, const_target_hash> widening_pointst;
+  widening_pointst widening_points;
+
+  typedef hash_map_cont<locationt, unsigned, const_target_hash>
+    update_countt;
+  update_countt update_count;
+
+  unsigned widening_delay, narrowing_rounds;
+  statisticst statistics;
+
+  void compute_iteration_order(const goto_programt &goto_program);
+  unsigned get_priority(locationt l) const;
+
+  // merges or widens, depending on the location
+  bool merge_or_widen(const statet &src, locationt from, locationt to);
   
   // true = found s.th. new
   bool fixedpoint(
     const goto_programt &goto_program,
     const goto_functionst &goto_functions,
     const namespacet &ns);
+
+  // same, but only for the locations in the working set
+  bool fixedpoint(
+    working_sett &working_set,
+    const goto_programt &goto_program,
+    const goto_functionst &goto_functions,
+    const namespacet &ns);
+
+  // descending iteration after the fixedpoint is reached
+  void narrowing(
+    const goto_programt &goto_program,
+    const goto_functionst &goto_functions,
+    const namespacet &ns);
     
   virtual void fixedpoint(
     const goto_functionst &goto_functions,
@@ -180,11 +295,19 @@ protected:
     const goto_functionst &goto_functions,
     const namespacet &ns);
   
+  // The states of a function body that has been analyzed
+  // are its summary: the body is only revisited, starting
+  // from its entry, when a call adds to the entry state.
   typedef std::set<irep_idt> functions_donet;
   functions_donet functions_done;
 
   typedef std::set<irep_idt> recursion_sett;
   recursion_sett recursion_set;
+
+  // calls that were reached while their callee was being
+  // analyzed, and hence did not feed their return edge
+  typedef hash_set_cont<locationt, const_target_hash> recursive_callst;
+  recursive_callst recursive_calls;
     
   // function calls
   bool do_function_call_rec(
@@ -204,6 +327,14 @@ protected:
   // abstract methods
     
   virtual bool merge(const statet &src, locationt from, locationt to)=0;
+  virtual bool widen(const statet &src, locationt from, locationt to)=0;
+  virtual bool narrow(const statet &src, locationt to)=0;
+  // joins two states that are not stored at a location
+  virtual bool merge_temporary(
+    statet &dest,
+    const statet &src,
+    locationt from,
+    locationt to)=0;
   // for concurrent fixedpoint
   virtual bool merge_shared(
     const statet &src,
@@ -270,6 +401,27 @@ protected:
     statet &dest=get_state(to);
     return static_cast<domainT &>(dest).merge(static_cast<const domainT &>(src), from, to);
   }
+
+  virtual bool widen(const statet &src, locationt from, locationt to)
+  {
+    statet &dest=get_state(to);
+    return static_cast<domainT &>(dest).widen(static_cast<const domainT &>(src), from, to);
+  }
+
+  virtual bool narrow(const statet &src, locationt to)
+  {
+    statet &dest=get_state(to);
+    return static_cast<domainT &>(dest).narrow(static_cast<const domainT &>(src), to);
+  }
+
+  virtual bool merge_temporary(
+    statet &dest,
+    const statet &src,
+    locationt from,
+    locationt to)
+  {
+    return static_cast<domainT &>(dest).merge(static_cast<const domainT &>(src), from, to);
+  }
   
   virtual statet *make_temporary_state(const statet &s)
   {
@@ -76,6 +76,16 @@ protected:
 class custom_bitvector_analysist:public ait<custom_bitvector_domaint> 
 {
 public:
+  custom_bitvector_analysist():number_of_threads(1)
+  {
+  }
+
+  // for computing the aliasing information of the functions
+  inline void set_number_of_threads(unsigned n)
+  {
+    number_of_threads=n;
+  }
+
   void instrument(goto_functionst &);
   void check(const namespacet &, const goto_functionst &, std::ostream &);
   exprt eval(const exprt &src, locationt loc);
@@ -86,11 +96,15 @@ protected:
   virtual void initialize(const goto_functionst &_goto_functions)
   {
     local_may_alias_factory(_goto_functions);
+
+    if(number_of_threads>1)
+      local_may_alias_factory.compute_all(number_of_threads);
   }
 
   friend class custom_bitvector_domaint;
 
   numbering<irep_idt> bits;
+  unsigned number_of_threads;
   
   local_may_alias_factoryt local_may_alias_factory;
 };
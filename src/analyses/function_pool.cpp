@@ -0,0 +1,229 @@
+/*******************************************************************\
+
+Module: Running Per-Function Analyses on a Pool of Threads
+
+\*******************************************************************/
+
+#include <algorithm>
+
+#ifdef HAVE_THREADS
+#include <atomic>
+#include <exception>
+#include <thread>
+#endif
+
+#include "function_pool.h"
+
+/*******************************************************************\
+
+   Class: larger_function_first
+
+ Purpose: order for handing out the work, so that long
+          functions do not end up on one thread at the end
+
+\*******************************************************************/
+
+template<class iteratort>
+struct larger_function_first
+{
+  bool operator()(iteratort a, iteratort b) const
+  {
+    return a->second.body.instructions.size()>
+           b->second.body.instructions.size();
+  }
+};
+
+/*******************************************************************\
+
+Function: run_sequential
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+template<class iteratort, class task_typet>
+static void run_sequential(
+  const std::vector<iteratort> &worklist,
+  task_typet &task)
+{
+  for(typename std::vector<iteratort>::const_iterator
+      it=worklist.begin();
+      it!=worklist.end();
+      it++)
+    task((*it)->first, (*it)->second);
+}
+
+/*******************************************************************\
+
+Function: run_parallel
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: the workers take the next function from the list
+          until it is exhausted; exceptions are re-thrown in
+          the calling thread once all workers are done
+
+\*******************************************************************/
+
+#ifdef HAVE_THREADS
+template<class iteratort, class task_typet>
+struct shared_workt
+{
+  const std::vector<iteratort> *worklist;
+  task_typet *task;
+  std::atomic<std::size_t> next;
+  std::atomic<bool> failed;
+  std::vector<std::exception_ptr> exceptions;
+};
+
+template<class iteratort, class task_typet>
+static void worker(shared_workt<iteratort, task_typet> &work)
+{
+  while(!work.failed)
+  {
+    std::size_t index=work.next++;
+
+    if(index>=work.worklist->size())
+      break;
+
+    iteratort f_it=(*work.worklist)[index];
+
+    try
+    {
+      (*work.task)(f_it->first, f_it->second);
+    }
+
+    catch(...)
+    {
+      work.exceptions[index]=std::current_exception();
+      work.failed=true;
+    }
+  }
+}
+
+template<class iteratort, class task_typet>
+static void run_parallel(
+  unsigned number_of_threads,
+  const std::vector<iteratort> &worklist,
+  task_typet &task)
+{
+  // lazily initialized shared objects must exist
+  // before the workers start
+  get_nil_irep();
+
+  shared_workt<iteratort, task_typet> work;
+  work.worklist=&worklist;
+  work.task=&task;
+  work.next=0;
+  work.failed=false;
+  work.exceptions.resize(worklist.size());
+
+  std::size_t number_of_workers=
+    std::min<std::size_t>(number_of_threads, worklist.size());
+
+  std::vector<std::thread> workers;
+  workers.reserve(number_of_workers);
+
+  for(std::size_t i=0; i<number_of_workers; i++)
+    workers.push_back(
+      std::thread(worker<iteratort, task_typet>, std::ref(work)));
+
+  for(std::size_t i=0; i<workers.size(); i++)
+    workers[i].join();
+
+  for(std::size_t i=0; i<work.exceptions.size(); i++)
+    if(work.exceptions[i])
+      std::rethrow_exception(work.exceptions[i]);
+}
+#endif
+
+/*******************************************************************\
+
+Function: run_pool
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+template<class iteratort, class task_typet>
+static void run_pool(
+  unsigned number_of_threads,
+  iteratort begin,
+  iteratort end,
+  task_typet &task)
+{
+  std::vector<iteratort> worklist;
+
+  for(iteratort it=begin; it!=end; it++)
+    worklist.push_back(it);
+
+  // stable, to keep the map order among functions of equal size
+  std::stable_sort(worklist.begin(), worklist.end(),
+                   larger_function_first<iteratort>());
+
+  #ifdef HAVE_THREADS
+  if(number_of_threads>1 && worklist.size()>1)
+  {
+    run_parallel(number_of_threads, worklist, task);
+    return;
+  }
+  #endif
+
+  run_sequential(worklist, task);
+}
+
+/*******************************************************************\
+
+Function: function_poolt::operator()
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void function_poolt::operator()(
+  goto_functionst &goto_functions,
+  taskt &task)
+{
+  run_pool(
+    number_of_threads,
+    goto_functions.function_map.begin(),
+    goto_functions.function_map.end(),
+    task);
+}
+
+/*******************************************************************\
+
+Function: function_poolt::operator()
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void function_poolt::operator()(
+  const goto_functionst &goto_functions,
+  const_taskt &task)
+{
+  run_pool(
+    number_of_threads,
+    goto_functions.function_map.begin(),
+    goto_functions.function_map.end(),
+    task);
+}
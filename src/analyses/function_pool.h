@@ -0,0 +1,69 @@
+/*******************************************************************\
+
+Module: Running Per-Function Analyses on a Pool of Threads
+
+\*******************************************************************/
+
+#ifndef CPROVER_ANALYSES_FUNCTION_POOL_H
+#define CPROVER_ANALYSES_FUNCTION_POOL_H
+
+#include <vector>
+
+#include <goto-programs/goto_functions.h>
+
+// Intraprocedural analyses and instrumentations only read the
+// goto program of one function, and write to state that belongs
+// to that function.  This runs them on a number of threads, if
+// the build has HAVE_THREADS, and one after another otherwise.
+// The functions are handed out in order of decreasing size, and
+// the results are kept in a slot per function, so the outcome
+// does not depend on the number of threads.
+
+class function_poolt
+{
+public:
+  explicit function_poolt(unsigned _number_of_threads):
+    number_of_threads(_number_of_threads)
+  {
+  }
+
+  class taskt
+  {
+  public:
+    virtual ~taskt()
+    {
+    }
+
+    // must not modify anything shared with other functions
+    virtual void operator()(
+      const irep_idt &identifier,
+      goto_functionst::goto_functiont &goto_function)=0;
+  };
+
+  // for analyses that do not modify the program
+  class const_taskt
+  {
+  public:
+    virtual ~const_taskt()
+    {
+    }
+
+    // must not modify anything shared with other functions
+    virtual void operator()(
+      const irep_idt &identifier,
+      const goto_functionst::goto_functiont &goto_function)=0;
+  };
+
+  void operator()(
+    goto_functionst &goto_functions,
+    taskt &task);
+
+  void operator()(
+    const goto_functionst &goto_functions,
+    const_taskt &task);
+
+protected:
+  unsigned number_of_threads;
+};
+
+#endif
@@ -22,6 +22,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/cprover_prefix.h>
 
 #include "local_bitvector_analysis.h"
+#include "function_pool.h"
 #include "goto_check.h"
 
 class goto_checkt
@@ -1639,6 +1640,39 @@ void goto_check(
   goto_check.goto_check(goto_function);
 }                    
 
+/*******************************************************************\
+
+   Class: goto_check_taskt
+
+ Purpose: one goto_checkt per function, as it keeps state
+          while instrumenting a function
+
+\*******************************************************************/
+
+class goto_check_taskt:public function_poolt::taskt
+{
+public:
+  goto_check_taskt(
+    const namespacet &_ns,
+    const optionst &_options):
+    ns(_ns),
+    options(_options)
+  {
+  }
+
+  virtual void operator()(
+    const irep_idt &identifier,
+    goto_functionst::goto_functiont &goto_function)
+  {
+    goto_checkt goto_check(ns, options);
+    goto_check.goto_check(goto_function);
+  }
+
+protected:
+  const namespacet &ns;
+  const optionst &options;
+};
+
 /*******************************************************************\
 
 Function: goto_check
@@ -1656,15 +1690,9 @@ void goto_check(
   const optionst &options,
   goto_functionst &goto_functions)
 {
-  goto_checkt goto_check(ns, options);
-  
-  for(goto_functionst::function_mapt::iterator
-      it=goto_functions.function_map.begin();
-      it!=goto_functions.function_map.end();
-      it++)
-  {
-    goto_check.goto_check(it->second);
-  }
+  goto_check_taskt task(ns, options);
+  function_poolt pool(options.get_unsigned_int_option("threads"));
+  pool(goto_functions, task);
 }                    
 
 /*******************************************************************\
@@ -1684,13 +1712,5 @@ void goto_check(
   goto_modelt &goto_model)
 {
   const namespacet ns(goto_model.symbol_table);
-  goto_checkt goto_check(ns, options);
-  
-  for(goto_functionst::function_mapt::iterator
-      it=goto_model.goto_functions.function_map.begin();
-      it!=goto_model.goto_functions.function_map.end();
-      it++)
-  {
-    goto_check.goto_check(it->second);
-  }
+  goto_check(ns, options, goto_model.goto_functions);
 }                    
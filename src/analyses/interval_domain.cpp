@@ -30,9 +30,16 @@ Function: interval_domaint::output
 \*******************************************************************/
 
 void interval_domaint::output(
-  const namespacet &ns,
-  std::ostream &out) const
+  std::ostream &out,
+  const ai_baset &ai,
+  const namespacet &ns) const
 {
+  if(bottom)
+  {
+    out << "BOTTOM\n";
+    return;
+  }
+
   for(int_mapt::const_iterator
       i_it=int_map.begin(); i_it!=int_map.end(); i_it++)
   {
@@ -41,7 +48,7 @@ void interval_domaint::output(
       out << i_it->second.lower << " <= ";
     out << i_it->first;
     if(i_it->second.upper_set)
-      out << " <= " << i_it->second.lower;
+      out << " <= " << i_it->second.upper;
     out << "\n";
   }
 
@@ -53,7 +60,7 @@ void interval_domaint::output(
       out << i_it->second.lower << " <= ";
     out << i_it->first;
     if(i_it->second.upper_set)
-      out << " <= " << i_it->second.lower;
+      out << " <= " << i_it->second.upper;
     out << "\n";
   }
 }
@@ -71,10 +78,13 @@ Function: interval_domaint::transform
 \*******************************************************************/
 
 void interval_domaint::transform(
-  const namespacet &ns,
   locationt from,
-  locationt to)
+  locationt to,
+  ai_baset &ai,
+  const namespacet &ns)
 {
+  if(bottom) return;
+
   const goto_programt::instructiont &instruction=*from;
   switch(instruction.type)
   {
@@ -130,17 +140,20 @@ Function: interval_domaint::merge
 
 \*******************************************************************/
 
-bool interval_domaint::merge(const interval_domaint &b, locationt to)
+bool interval_domaint::merge(
+  const interval_domaint &b,
+  locationt from,
+  locationt to)
 {
-  if(!b.seen) return false;
-  if(!seen) { *this=b; return true; }
+  if(b.bottom) return false;
+  if(bottom) { *this=b; return true; }
 
   bool result=false;
   
   for(int_mapt::iterator it=int_map.begin();
       it!=int_map.end(); ) // no it++
   {
-    const int_mapt::const_iterator b_it=b.int_map.begin();
+    const int_mapt::const_iterator b_it=b.int_map.find(it->first);
     if(b_it==b.int_map.end())
     {
       int_mapt::iterator next=it;
@@ -161,7 +174,7 @@ bool interval_domaint::merge(const interval_domaint &b, locationt to)
   for(float_mapt::iterator it=float_map.begin();
       it!=float_map.end(); ) // no it++
   {
-    const float_mapt::const_iterator b_it=b.float_map.begin();
+    const float_mapt::const_iterator b_it=b.float_map.find(it->first);
     if(b_it==b.float_map.end())
     {
       float_mapt::iterator next=it;
@@ -184,6 +197,107 @@ bool interval_domaint::merge(const interval_domaint &b, locationt to)
 
 /*******************************************************************\
 
+Function: interval_domaint::widen
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: like merge, but bounds that are not stable are dropped
+
+\*******************************************************************/
+
+bool interval_domaint::widen(
+  const interval_domaint &b,
+  locationt from,
+  locationt to)
+{
+  if(b.bottom) return false;
+  if(bottom) { *this=b; return true; }
+
+  bool result=false;
+  
+  for(int_mapt::iterator it=int_map.begin();
+      it!=int_map.end(); ) // no it++
+  {
+    const int_mapt::const_iterator b_it=b.int_map.find(it->first);
+    if(b_it==b.int_map.end())
+    {
+      int_mapt::iterator next=it;
+      next++;
+      int_map.erase(it);
+      it=next;
+      result=true;
+    }
+    else
+    {
+      if(it->second.widen(b_it->second))
+        result=true;
+        
+      it++;
+    }
+  }
+
+  for(float_mapt::iterator it=float_map.begin();
+      it!=float_map.end(); ) // no it++
+  {
+    const float_mapt::const_iterator b_it=b.float_map.find(it->first);
+    if(b_it==b.float_map.end())
+    {
+      float_mapt::iterator next=it;
+      next++;
+      float_map.erase(it);
+      it=next;
+      result=true;
+    }
+    else
+    {
+      if(it->second.widen(b_it->second))
+        result=true;
+        
+      it++;
+    }
+  }
+
+  return result;
+}
+
+/*******************************************************************\
+
+Function: interval_domaint::narrow
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: refine the bounds that are not set using "b"
+
+\*******************************************************************/
+
+bool interval_domaint::narrow(
+  const interval_domaint &b,
+  locationt to)
+{
+  if(bottom) return false;
+  if(b.bottom) { *this=b; return true; }
+
+  bool result=false;
+
+  for(int_mapt::const_iterator b_it=b.int_map.begin();
+      b_it!=b.int_map.end(); b_it++)
+    if(int_map[b_it->first].narrow(b_it->second))
+      result=true;
+
+  for(float_mapt::const_iterator b_it=b.float_map.begin();
+      b_it!=b.float_map.end(); b_it++)
+    if(float_map[b_it->first].narrow(b_it->second))
+      result=true;
+
+  return result;
+}
+
+/*******************************************************************\
+
 Function: interval_domaint::assign
 
   Inputs:
@@ -261,6 +375,9 @@ void interval_domaint::assume_rec(
     assume_rec(lhs, ID_le, rhs);
     return;
   }
+
+  if(id==ID_notequal)
+    return; // an interval can't be split
   
   if(id==ID_ge)
     return assume_rec(rhs, ID_le, lhs);    
@@ -407,6 +524,9 @@ Function: interval_domaint::make_expression
 
 exprt interval_domaint::make_expression(const symbol_exprt &src) const
 {
+  if(bottom)
+    return false_exprt();
+
   if(is_int(src.type()))
   {
     int_mapt::const_iterator i_it=int_map.find(src.get_identifier());
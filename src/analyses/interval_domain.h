@@ -12,15 +12,19 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/ieee_float.h>
 #include <util/mp_arith.h>
 
-#include "static_analysis.h"
+#include "ai.h"
 #include "interval_analysis.h"
 #include "intervals.h"
 
-class interval_domaint:public domain_baset
+class interval_domaint:public ai_domain_baset
 {
 public:
   // trivial, conjunctive interval domain for both float
   // and integers
+
+  interval_domaint():bottom(true)
+  {
+  }
   
   typedef std::map<irep_idt, integer_intervalt> int_mapt;
   typedef std::map<irep_idt, ieee_float_intervalt> float_mapt;
@@ -29,15 +33,26 @@ public:
   float_mapt float_map;
 
   virtual void transform(
-    const namespacet &ns,
     locationt from,
-    locationt to);
+    locationt to,
+    ai_baset &ai,
+    const namespacet &ns);
               
   virtual void output(
-    const namespacet &ns,
-    std::ostream &out) const;
+    std::ostream &out,
+    const ai_baset &ai,
+    const namespacet &ns) const;
+
+  virtual void make_entry()
+  {
+    bottom=false;
+    int_map.clear();
+    float_map.clear();
+  }
 
-  bool merge(const interval_domaint &b, locationt to);
+  bool merge(const interval_domaint &b, locationt from, locationt to);
+  bool widen(const interval_domaint &b, locationt from, locationt to);
+  bool narrow(const interval_domaint &b, locationt to);
   
   exprt make_expression(const symbol_exprt &) const;
   
@@ -51,7 +66,14 @@ public:
     return src.id()==ID_floatbv;
   }
 
+  inline bool is_bottom() const
+  {
+    return bottom;
+  }
+
 protected:
+  bool bottom;
+
   void havoc_rec(const exprt &);
   void assume_rec(const exprt &, bool negation=false);
   void assume_rec(const exprt &lhs, irep_idt id, const exprt &rhs);
@@ -66,6 +66,12 @@ public:
 
   // Intersection or conjunction
   bool meet(const interval_templatet<T> &other);
+
+  // Widening: drop the bounds that are not stable
+  bool widen(const interval_templatet<T> &other);
+
+  // Narrowing: refine the bounds that are not set
+  bool narrow(const interval_templatet<T> &other);
 };
 
 // return 'true' if there is change
@@ -173,6 +179,52 @@ bool interval_templatet<T>::meet(const interval_templatet<T> &other)
   return result;
 }
 
+// Widening
+// return 'true' if there is change
+template<typename T>
+bool interval_templatet<T>::widen(const interval_templatet<T> &other)
+{
+  bool result=false;
+
+  if(upper_set)
+    if(!other.upper_set || upper<other.upper)
+    {
+      upper_set=false;
+      result=true;
+    }
+
+  if(lower_set)
+    if(!other.lower_set || lower>other.lower)
+    {
+      lower_set=false;
+      result=true;
+    }
+
+  return result;
+}
+
+// Narrowing
+// return 'true' if there is change
+template<typename T>
+bool interval_templatet<T>::narrow(const interval_templatet<T> &other)
+{
+  bool result=false;
+
+  if(!upper_set && other.upper_set)
+  {
+    set_upper(other.upper);
+    result=true;
+  }
+
+  if(!lower_set && other.lower_set)
+  {
+    set_lower(other.lower);
+    result=true;
+  }
+
+  return result;
+}
+
 typedef interval_templatet<mp_integer> integer_intervalt;
 typedef interval_templatet<ieee_floatt> ieee_float_intervalt;
 
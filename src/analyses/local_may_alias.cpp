@@ -16,6 +16,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <ansi-c/c_types.h>
 #include <langapi/language_util.h>
 
+#include "function_pool.h"
 #include "local_may_alias.h"
 
 /*******************************************************************\
@@ -511,3 +512,64 @@ void local_may_aliast::output(
   }
 }
 
+
+/*******************************************************************\
+
+   Class: local_may_alias_taskt
+
+ Purpose: fills the slot of one function
+
+\*******************************************************************/
+
+class local_may_alias_taskt:public function_poolt::const_taskt
+{
+public:
+  typedef std::map<irep_idt, std::unique_ptr<local_may_aliast> > fkt_mapt;
+
+  explicit local_may_alias_taskt(fkt_mapt &_fkt_map):fkt_map(_fkt_map)
+  {
+  }
+
+  virtual void operator()(
+    const irep_idt &identifier,
+    const goto_functionst::goto_functiont &goto_function)
+  {
+    fkt_mapt::iterator f_it=fkt_map.find(identifier);
+
+    // slots are only made for functions with body
+    if(f_it==fkt_map.end() || f_it->second)
+      return;
+
+    f_it->second=std::unique_ptr<local_may_aliast>(
+      new local_may_aliast(goto_function));
+  }
+
+protected:
+  fkt_mapt &fkt_map;
+};
+
+/*******************************************************************\
+
+Function: local_may_alias_factoryt::compute_all
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void local_may_alias_factoryt::compute_all(unsigned number_of_threads)
+{
+  assert(goto_functions!=NULL);
+
+  // make the slots first, the workers must not change the map
+  forall_goto_functions(f_it, *goto_functions)
+    if(f_it->second.body_available)
+      fkt_map[f_it->first];
+
+  local_may_alias_taskt task(fkt_map);
+  function_poolt pool(number_of_threads);
+  pool(*goto_functions, task);
+}
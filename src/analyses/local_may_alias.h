@@ -131,6 +131,10 @@ public:
     assert(t_it!=target_map.end());
     return operator()(t_it->second);
   }
+
+  // computes the analysis for all functions with body
+  // up front, on the given number of threads
+  void compute_all(unsigned number_of_threads);
   
   std::set<exprt> get(
     const goto_programt::const_targett t,
@@ -452,26 +452,27 @@ void rd_range_domaint::kill(
 
   bool clear_export_cache=false;
   values_innert new_values;
+  std::vector<std::size_t> killed;
 
-  for(values_innert::iterator
+  for(values_innert::const_iterator
       it=entry->second.begin();
       it!=entry->second.end();
-     ) // no ++it
+      ++it)
   {
     const reaching_definitiont &v=bv_container->get(*it);
 
     if(v.bit_begin >= range_end)
-      ++it;
+      continue;
     else if(v.bit_end!=-1 &&
             v.bit_end <= range_start)
-      ++it;
+      continue;
     else if(v.bit_begin >= range_start &&
             v.bit_end!=-1 &&
             v.bit_end <= range_end) // rs <= a < b <= re
     {
       clear_export_cache=true;
 
-      entry->second.erase(it++);
+      killed.push_back(*it);
     }
     else if(v.bit_begin >= range_start) // rs <= a <= re < b
     {
@@ -481,7 +482,7 @@ void rd_range_domaint::kill(
       v_new.bit_begin=range_end;
       new_values.insert(bv_container->add(v_new));
 
-      entry->second.erase(it++);
+      killed.push_back(*it);
     }
     else if(v.bit_end==-1 ||
             v.bit_end > range_end) // a <= rs < re < b
@@ -497,7 +498,7 @@ void rd_range_domaint::kill(
       new_values.insert(bv_container->add(v_new));
       new_values.insert(bv_container->add(v_new2));
 
-      entry->second.erase(it++);
+      killed.push_back(*it);
     }
     else // a <= rs < b <= re
     {
@@ -507,31 +508,20 @@ void rd_range_domaint::kill(
       v_new.bit_end=range_start;
       new_values.insert(bv_container->add(v_new));
 
-      entry->second.erase(it++);
+      killed.push_back(*it);
     }
   }
 
   if(clear_export_cache)
     export_cache.erase(identifier);
 
-  values_innert::iterator it=entry->second.begin();
-  for(values_innert::const_iterator
-      itn=new_values.begin();
-      itn!=new_values.end();
-      ++itn)
-  {
-    while(it!=entry->second.end() && *it<*itn)
-      ++it;
-    if(it==entry->second.end() || *itn<*it)
-    {
-      entry->second.insert(it, *itn);
-    }
-    else if(it!=entry->second.end())
-    {
-      assert(*it==*itn);
-      ++it;
-    }
-  }
+  for(std::vector<std::size_t>::const_iterator
+      it=killed.begin();
+      it!=killed.end();
+      ++it)
+    entry->second.erase(*it);
+
+  entry->second.merge(new_values);
 }
 
 /*******************************************************************\
@@ -613,7 +603,7 @@ bool rd_range_domaint::gen(
   v.bit_begin=range_start;
   v.bit_end=range_end;
 
-  if(!values[identifier].insert(bv_container->add(v)).second)
+  if(!values[identifier].insert(bv_container->add(v)))
     return false;
 
   export_cache.erase(identifier);
@@ -756,25 +746,7 @@ bool rd_range_domaint::merge_inner(
     }
   }
 #else
-  values_innert::iterator itr=dest.begin();
-  for(values_innert::const_iterator
-      itro=other.begin();
-      itro!=other.end();
-      ++itro)
-  {
-    while(itr!=dest.end() && *itr<*itro)
-      ++itr;
-    if(itr==dest.end() || *itro<*itr)
-    {
-      dest.insert(itr, *itro);
-      more=true;
-    }
-    else if(itr!=dest.end())
-    {
-      assert(*itr==*itro);
-      ++itr;
-    }
-  }
+  more=dest.merge(other);
 #endif
 
   return more;
@@ -12,6 +12,8 @@ Date: February 2013
 #ifndef CPROVER_REACHING_DEFINITIONS_H
 #define CPROVER_REACHING_DEFINITIONS_H
 
+#include <util/chunked_bitset.h>
+
 #include "ai.h"
 #include "goto_rw.h"
 
@@ -131,7 +133,9 @@ public:
 protected:
   sparse_bitvector_analysist<reaching_definitiont> *bv_container;
 
-  typedef std::set<std::size_t> values_innert;
+  // indices into bv_container, stored as bit words, so that
+  // merges are done a word at a time
+  typedef chunked_bitsett values_innert;
   #ifdef USE_DSTRING
   typedef std::map<irep_idt, values_innert> valuest;
   #else
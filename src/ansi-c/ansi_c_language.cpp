@@ -7,6 +7,7 @@ Author: Daniel Kroening, kroening@kroening.com
 \*******************************************************************/
 
 #include <cstring>
+#include <iterator>
 #include <sstream>
 #include <fstream>
 
@@ -114,17 +115,99 @@ bool ansi_c_languaget::parse(
   if(preprocess(instream, path, o_preprocessed))
     return true;
 
-  std::istringstream i_preprocessed(o_preprocessed.str());
+  const std::string preprocessed=o_preprocessed.str();
 
   // parsing
 
   std::string code;
   ansi_c_internal_additions(code);
-  std::istringstream codestr(code);
 
+  header_items=0;
+  header_read=false;
+  header_scope=ansi_c_scopet();
+  header_symbol_table.clear();
+
+  std::size_t header_size=std::string::npos;
+
+  if(header_cache.enabled())
+  {
+    header_size=header_cachet::header_size(preprocessed);
+
+    if(header_size!=std::string::npos)
+    {
+      header_cache.set_key(code, preprocessed.substr(0, header_size));
+      header_read=!header_cache.read(header_scope, header_symbol_table);
+    }
+  }
+
+  start_parsing();
+
+  bool result;
+
+  if(header_read)
+  {
+    // the headers have been done before
+    statistics() << "Reusing the headers of " << path << eom;
+
+    ansi_c_parser.root_scope()=header_scope;
+    result=parse_text(preprocessed.substr(header_size), path);
+  }
+  else
+  {
+    result=parse_text(code, ID_built_in);
+
+    if(!result && header_size!=std::string::npos)
+    {
+      // the headers on their own, unless they end in the middle
+      // of something, in which case we start over
+      null_message_handlert null_message_handler;
+      ansi_c_parser.set_message_handler(null_message_handler);
+
+      if(!parse_text(preprocessed.substr(0, header_size), path) &&
+         ansi_c_parser.scopes.size()==1 &&
+         ansi_c_parser.pragma_pack.empty())
+      {
+        header_items=ansi_c_parser.parse_tree.items.size();
+        header_scope=ansi_c_parser.root_scope();
+
+        ansi_c_parser.set_message_handler(get_message_handler());
+        result=parse_text(preprocessed.substr(header_size), path);
+      }
+      else
+      {
+        start_parsing();
+        result=parse_text(code, ID_built_in) ||
+               parse_text(preprocessed, path);
+      }
+    }
+    else if(!result)
+      result=parse_text(preprocessed, path);
+  }
+
+  // save result
+  parse_tree.swap(ansi_c_parser.parse_tree);
+
+  // save some memory
+  ansi_c_parser.clear();
+
+  return result;
+}
+
+/*******************************************************************\
+
+Function: ansi_c_languaget::start_parsing
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: set up the parser for a new file
+
+\*******************************************************************/
+
+void ansi_c_languaget::start_parsing()
+{
   ansi_c_parser.clear();
-  ansi_c_parser.set_file(ID_built_in);
-  ansi_c_parser.in=&codestr;
   ansi_c_parser.set_message_handler(get_message_handler());
   ansi_c_parser.for_has_scope=config.ansi_c.for_has_scope;
   ansi_c_parser.cpp98=false; // it's not C++
@@ -156,27 +239,32 @@ bool ansi_c_languaget::parse(
   default:
     assert(false);
   }
+}
 
-  ansi_c_scanner_init();
+/*******************************************************************\
 
-  bool result=ansi_c_parser.parse();
+Function: ansi_c_languaget::parse_text
 
-  if(!result)
-  {
-    ansi_c_parser.set_line_no(0);
-    ansi_c_parser.set_file(path);
-    ansi_c_parser.in=&i_preprocessed;
-    ansi_c_scanner_init();
-    result=ansi_c_parser.parse();
-  }
+  Inputs:
 
-  // save result
-  parse_tree.swap(ansi_c_parser.parse_tree);
+ Outputs: true on error
 
-  // save some memory
-  ansi_c_parser.clear();
+ Purpose: parse more declarations into the parser's tree
 
-  return result;
+\*******************************************************************/
+
+bool ansi_c_languaget::parse_text(
+  const std::string &text,
+  const irep_idt &file)
+{
+  std::istringstream in(text);
+
+  ansi_c_parser.set_line_no(0);
+  ansi_c_parser.set_file(file);
+  ansi_c_parser.in=&in;
+  ansi_c_scanner_init();
+
+  return ansi_c_parser.parse();
 }
              
 /*******************************************************************\
@@ -197,7 +285,39 @@ bool ansi_c_languaget::typecheck(
 {
   symbol_tablet new_symbol_table;
 
-  if(ansi_c_typecheck(parse_tree, new_symbol_table, module, get_message_handler()))
+  // the headers, see header_cache.h
+  ansi_c_parse_treet headers;
+
+  if(header_read)
+  {
+    forall_symbols(it, header_symbol_table.symbols)
+    {
+      symbolt symbol=it->second;
+      symbol.module=module;
+      new_symbol_table.add(symbol);
+    }
+  }
+  else if(header_items!=0)
+  {
+    ansi_c_parse_treet::itemst::iterator end=parse_tree.items.begin();
+    std::advance(end, header_items);
+
+    headers.items.splice(
+      headers.items.end(), parse_tree.items, parse_tree.items.begin(), end);
+
+    if(ansi_c_typecheck(headers, new_symbol_table, module, get_message_handler()))
+      return true;
+
+    header_cache.write(header_scope, new_symbol_table);
+  }
+
+  bool failed=
+    ansi_c_typecheck(parse_tree, new_symbol_table, module, get_message_handler());
+
+  // put back what has been parsed
+  parse_tree.items.splice(parse_tree.items.begin(), headers.items);
+
+  if(failed)
     return true;
 
   remove_internal_symbols(new_symbol_table);
@@ -12,8 +12,10 @@ Author: Daniel Kroening, kroening@kroening.com
 /*! \defgroup gr_ansi_c ANSI-C front-end */
 
 #include <util/language.h>
+#include <util/symbol_table.h>
 
 #include "ansi_c_parse_tree.h"
+#include "header_cache.h"
 
 /*! \brief TO_BE_DOCUMENTED
     \ingroup gr_ansi_c
@@ -40,7 +42,7 @@ public:
   virtual void show_parse(std::ostream &out);
   
   virtual ~ansi_c_languaget();
-  ansi_c_languaget() { }
+  ansi_c_languaget():header_items(0), header_read(false) { }
   
   virtual bool from_expr(
     const exprt &expr,
@@ -70,6 +72,17 @@ public:
 protected:
   ansi_c_parse_treet parse_tree;
   std::string parse_path;
+
+  // the state after the headers the file starts with: the number
+  // of declarations to typecheck and cache, or what has been read
+  header_cachet header_cache;
+  std::size_t header_items;
+  bool header_read;
+  ansi_c_scopet header_scope;
+  symbol_tablet header_symbol_table;
+
+  void start_parsing();
+  bool parse_text(const std::string &text, const irep_idt &file);
 };
  
 languaget *new_ansi_c_language();
@@ -26,6 +26,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/message_stream.h>
 #include <util/tempfile.h>
 #include <util/unicode.h>
+#include <util/pipe_stream.h>
 #include <util/arith_tools.h>
 #include <util/std_types.h>
 
@@ -205,11 +206,22 @@ Function: c_preprocess
 
 \*******************************************************************/
 
+bool c_preprocess_gcc_clang(const std::string &, std::istream *, std::ostream &, message_handlert &, configt::ansi_ct::preprocessort);
+
 bool c_preprocess(
   std::istream &instream,
   std::ostream &outstream,
   message_handlert &message_handler)
 {
+  #ifndef _WIN32
+  // gcc and clang read it through a pipe
+  if(config.ansi_c.preprocessor==configt::ansi_ct::PP_GCC ||
+     config.ansi_c.preprocessor==configt::ansi_ct::PP_CLANG)
+    return c_preprocess_gcc_clang(
+      "-", &instream, outstream, message_handler,
+      config.ansi_c.preprocessor);
+  #endif
+
   std::string file=get_temporary_file("tmp.stdin", ".c");
   FILE *tmp=fopen(file.c_str(), "wt");
 
@@ -261,7 +273,6 @@ Function: c_preprocess
 
 bool c_preprocess_codewarrior(const std::string &, std::ostream &, message_handlert &);
 bool c_preprocess_arm(const std::string &, std::ostream &, message_handlert &);
-bool c_preprocess_gcc_clang(const std::string &, std::ostream &, message_handlert &, configt::ansi_ct::preprocessort);
 bool c_preprocess_none(const std::string &, std::ostream &, message_handlert &);
 bool c_preprocess_visual_studio(const std::string &, std::ostream &, message_handlert &);
 
@@ -276,10 +287,10 @@ bool c_preprocess(
     return c_preprocess_codewarrior(path, outstream, message_handler);
   
   case configt::ansi_ct::PP_GCC:
-    return c_preprocess_gcc_clang(path, outstream, message_handler, config.ansi_c.preprocessor);
+    return c_preprocess_gcc_clang(path, NULL, outstream, message_handler, config.ansi_c.preprocessor);
   
   case configt::ansi_ct::PP_CLANG:
-    return c_preprocess_gcc_clang(path, outstream, message_handler, config.ansi_c.preprocessor);
+    return c_preprocess_gcc_clang(path, NULL, outstream, message_handler, config.ansi_c.preprocessor);
   
   case configt::ansi_ct::PP_VISUAL_STUDIO:
     return c_preprocess_visual_studio(path, outstream, message_handler);
@@ -599,6 +610,7 @@ Function: c_preprocess_gcc_clang
 
 bool c_preprocess_gcc_clang(
   const std::string &file,
+  std::istream *instream,
   std::ostream &outstream,
   message_handlert &message_handler,
   configt::ansi_ct::preprocessort preprocessor)
@@ -610,8 +622,6 @@ bool c_preprocess_gcc_clang(
   // preprocessing
   message_streamt message_stream(message_handler);
 
-  std::string stderr_file=get_temporary_file("tmp.stderr", "");
-
   std::string command;
   
   if(preprocessor==configt::ansi_ct::PP_CLANG)
@@ -817,6 +827,7 @@ bool c_preprocess_gcc_clang(
   }
 
   #ifdef _WIN32
+  std::string stderr_file=get_temporary_file("tmp.stderr", "");
   std::string tmpi=get_temporary_file("tmp.gcc", "");
   command+=" \""+file+"\"";
   command+=" -o \""+tmpi+"\"";
@@ -854,33 +865,65 @@ bool c_preprocess_gcc_clang(
     result=1;
   }
   #else
-  command+=" \""+file+"\"";
-  command+=" 2> \""+stderr_file+"\"";
+  // no temporary files: the input, if not a file, the output
+  // and the errors/warnings all go through pipes
+  if(instream!=NULL)
+    command+=" -";
+  else
+    command+=" "+shell_quote(file);
 
-  FILE *stream=popen(command.c_str(), "r");
+  std::list<std::string> args;
+  args.push_back("-c");
+  args.push_back(command);
 
-  if(stream!=NULL)
-  {
-    int ch;
-    while((ch=fgetc(stream))!=EOF)
-      outstream << (unsigned char)ch;
+  pipe_stream process("/bin/sh", args);
+  process.capture_stderr();
 
-    result=pclose(stream);
-  }
-  else
+  if(process.run()==-1)
   {
-    message_stream.str << "GCC preprocessing failed (popen failed)" << std::endl;
+    message_stream.str << "GCC preprocessing failed (pipe failed)" << std::endl;
     result=1;
   }
-
-  // errors/warnings
+  else
   {
-    std::ifstream stderr_stream(stderr_file.c_str());
-    if(stderr_stream)
-      message_stream.str << stderr_stream.rdbuf();
-  }
+    bool write_failed=false;
 
-  unlink(stderr_file.c_str());
+    if(instream!=NULL)
+    {
+      char buffer[4096];
+
+      // fails if the preprocessor is missing or terminates early
+      while(instream->read(buffer, sizeof(buffer)) || instream->gcount()!=0)
+        if(process.rdbuf()->sputn(buffer, instream->gcount())!=
+           instream->gcount())
+        {
+          write_failed=true;
+          break;
+        }
+    }
+
+    process.close_in();
+
+    {
+      char buffer[4096];
+      std::streamsize len;
+
+      while((len=process.rdbuf()->sgetn(buffer, sizeof(buffer)))>0)
+        outstream.write(buffer, len);
+    }
+
+    result=process.wait();
+
+    // errors/warnings
+    message_stream.str << process.stderr_text();
+
+    if(write_failed && result==0)
+    {
+      message_stream.str << "GCC preprocessing failed (write failed)"
+                         << std::endl;
+      result=1;
+    }
+  }
 
   #endif
 
@@ -41,6 +41,63 @@ void add_cprover_library(
   if(config.ansi_c.lib==configt::ansi_ct::LIB_NONE)
     return;
 
+  std::set<irep_idt> library_functions;
+
+  for(std::set<irep_idt>::const_iterator
+      it=functions.begin();
+      it!=functions.end();
+      it++)
+  {
+    symbol_tablet::symbolst::const_iterator old=
+      symbol_table.symbols.find(*it);
+
+    if(old!=symbol_table.symbols.end() &&
+       old->second.value.is_nil())
+      library_functions.insert(*it);
+  }
+
+  std::string library_text=
+    get_cprover_library_text(library_functions);
+
+  if(!library_text.empty())
+    add_library(library_text, symbol_table, message_handler);
+}
+
+/*******************************************************************\
+
+Function: get_cprover_library_functions
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void get_cprover_library_functions(std::set<irep_idt> &dest)
+{
+  for(cprover_library_entryt *e=cprover_library;
+      e->function!=NULL;
+      e++)
+    dest.insert(e->function);
+}
+
+/*******************************************************************\
+
+Function: get_cprover_library_text
+
+  Inputs: functions to be modelled
+
+ Outputs: the models, or the empty string if there is none
+
+ Purpose:
+
+\*******************************************************************/
+
+std::string get_cprover_library_text(
+  const std::set<irep_idt> &functions)
+{
   std::ostringstream library_text;
 
   library_text <<
@@ -60,35 +117,50 @@ void add_cprover_library(
     
     if(functions.find(id)!=functions.end())
     {
-      symbol_tablet::symbolst::const_iterator old=
-        symbol_table.symbols.find(id);
-
-      if(old!=symbol_table.symbols.end() &&
-         old->second.value.is_nil())
-      {
-        count++;
-        library_text << e->model << '\n';
-      }
+      count++;
+      library_text << e->model << '\n';
     }
   }
 
-  if(count>0)
-  {
-    std::istringstream in(library_text.str());
-    
-    // switch mode temporarily from gcc C++ to gcc C flavour
-    configt::ansi_ct::flavourt old_mode=config.ansi_c.mode;
-    
-    if(config.ansi_c.mode==configt::ansi_ct::MODE_GCC_CPP)
-      config.ansi_c.mode=configt::ansi_ct::MODE_GCC_C;
-    
-    ansi_c_languaget ansi_c_language;
-    ansi_c_language.set_message_handler(message_handler);
-    ansi_c_language.parse(in, "");
-    
-    ansi_c_language.typecheck(symbol_table, "<built-in-library>");
+  if(count==0)
+    return std::string();
 
-    config.ansi_c.mode=old_mode;
-  }
+  return library_text.str();
 }
 
+/*******************************************************************\
+
+Function: add_library
+
+  Inputs:
+
+ Outputs: true on error
+
+ Purpose:
+
+\*******************************************************************/
+
+bool add_library(
+  const std::string &src,
+  symbol_tablet &symbol_table,
+  message_handlert &message_handler)
+{
+  std::istringstream in(src);
+  
+  // switch mode temporarily from gcc C++ to gcc C flavour
+  configt::ansi_ct::flavourt old_mode=config.ansi_c.mode;
+  
+  if(config.ansi_c.mode==configt::ansi_ct::MODE_GCC_CPP)
+    config.ansi_c.mode=configt::ansi_ct::MODE_GCC_C;
+  
+  ansi_c_languaget ansi_c_language;
+  ansi_c_language.set_message_handler(message_handler);
+
+  bool result=
+    ansi_c_language.parse(in, "") ||
+    ansi_c_language.typecheck(symbol_table, "<built-in-library>");
+
+  config.ansi_c.mode=old_mode;
+
+  return result;
+}
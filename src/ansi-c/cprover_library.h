@@ -10,6 +10,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #define CPROVER_ANSI_C_CPROVER_LIBRARY_H
 
 #include <set>
+#include <string>
 
 #include <util/symbol_table.h>
 #include <util/message.h>
@@ -19,4 +20,20 @@ void add_cprover_library(
   symbol_tablet &symbol_table,
   message_handlert &message_handler);
 
+// The following are for building the whole library at once,
+// e.g., to keep it as a goto binary.
+
+// the names of all the functions that have a model
+void get_cprover_library_functions(std::set<irep_idt> &dest);
+
+// the text of the models of the given functions, as C
+std::string get_cprover_library_text(
+  const std::set<irep_idt> &functions);
+
+// parses and type-checks library text, true on error
+bool add_library(
+  const std::string &src,
+  symbol_tablet &symbol_table,
+  message_handlert &message_handler);
+
 #endif
@@ -0,0 +1,336 @@
+/*******************************************************************\
+
+Module: Caching the Headers a C File Starts With
+
+\*******************************************************************/
+
+#include <cstdlib>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <new>
+#include <stdexcept>
+
+#include <util/cache_file.h>
+#include <util/config.h>
+#include <util/irep_table.h>
+#include <util/symbol_table.h>
+
+#include <cbmc/version.h>
+
+#include "header_cache.h"
+
+/*******************************************************************\
+
+Function: header_cachet::header_cachet
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+header_cachet::header_cachet()
+{
+  const char *cache_dir=getenv("CPROVER_HEADER_CACHE");
+
+  if(cache_dir!=NULL)
+    directory=cache_dir;
+}
+
+/*******************************************************************\
+
+Function: is_line_marker
+
+  Inputs: a line of preprocessed text
+
+ Outputs: true if it is a line marker, i.e., '# 1 "file" ...'
+          or '#line 1 "file"', with the file name, if any
+
+ Purpose:
+
+\*******************************************************************/
+
+static bool is_line_marker(
+  const char *p,
+  const char *end,
+  std::string &file)
+{
+  while(p!=end && (*p==' ' || *p=='\t')) p++;
+
+  if(p==end || *p!='#')
+    return false;
+
+  p++;
+
+  while(p!=end && (*p==' ' || *p=='\t')) p++;
+
+  if(end-p>=4 && std::string(p, 4)=="line")
+  {
+    p+=4;
+    while(p!=end && (*p==' ' || *p=='\t')) p++;
+  }
+
+  if(p==end || !isdigit(*p))
+    return false; // e.g., #pragma
+
+  while(p!=end && isdigit(*p)) p++;
+  while(p!=end && (*p==' ' || *p=='\t')) p++;
+
+  file.clear();
+
+  if(p!=end && *p=='"')
+  {
+    for(p++; p!=end && *p!='"'; p++)
+    {
+      if(*p=='\\' && p+1!=end)
+        file+=*p++;
+      file+=*p;
+    }
+  }
+
+  return true;
+}
+
+/*******************************************************************\
+
+Function: header_cachet::header_size
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+std::size_t header_cachet::header_size(const std::string &preprocessed)
+{
+  // the first line marker names the file itself
+  std::string main_file, current_file, file;
+  bool have_main_file=false;
+  std::size_t last_marker=std::string::npos;
+
+  const char *text=preprocessed.data();
+
+  for(std::size_t pos=0; pos<preprocessed.size(); )
+  {
+    std::size_t end=preprocessed.find('\n', pos);
+    if(end==std::string::npos)
+      end=preprocessed.size();
+
+    if(is_line_marker(text+pos, text+end, file))
+    {
+      if(!file.empty())
+        current_file=file;
+
+      if(!have_main_file)
+      {
+        main_file=current_file;
+        have_main_file=true;
+      }
+
+      last_marker=pos;
+    }
+    else
+    {
+      bool blank=true;
+
+      for(std::size_t i=pos; i<end && blank; i++)
+        if(!isspace(text[i]))
+          blank=false;
+
+      if(!blank)
+      {
+        if(!have_main_file)
+          return std::string::npos;
+
+        if(current_file==main_file)
+          return last_marker;
+      }
+    }
+
+    pos=end+1;
+  }
+
+  return std::string::npos;
+}
+
+/*******************************************************************\
+
+Function: header_cachet::set_key
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: the file name is a hash of everything the state after
+          the headers depends on
+
+\*******************************************************************/
+
+void header_cachet::set_key(
+  const std::string &built_in,
+  const std::string &headers)
+{
+  const configt::ansi_ct &ansi_c=config.ansi_c;
+
+  std::ostringstream key;
+
+  key << "C " CBMC_VERSION " "
+      << ansi_c.int_width << ' ' << ansi_c.long_int_width << ' '
+      << ansi_c.bool_width << ' ' << ansi_c.char_width << ' '
+      << ansi_c.short_int_width << ' ' << ansi_c.long_long_int_width << ' '
+      << ansi_c.pointer_width << ' ' << ansi_c.single_width << ' '
+      << ansi_c.double_width << ' ' << ansi_c.long_double_width << ' '
+      << ansi_c.wchar_t_width << ' '
+      << ansi_c.char_is_unsigned << ansi_c.wchar_t_is_unsigned
+      << ansi_c.use_fixed_for_float << ansi_c.for_has_scope
+      << ansi_c.single_precision_constant << ansi_c.cpp11
+      << ansi_c.NULL_is_zero << ansi_c.string_abstraction << ' '
+      << ansi_c.rounding_mode << ' ' << ansi_c.alignment << ' '
+      << ansi_c.memory_operand_size << ' ' << ansi_c.endianness << ' '
+      << ansi_c.os << ' ' << ansi_c.arch << ' '
+      << ansi_c.mode << '\n';
+
+  fnv_hasht hash;
+
+  const std::string key_string=key.str();
+  const std::string *parts[]={ &key_string, &built_in, &headers };
+
+  for(unsigned p=0; p<sizeof(parts)/sizeof(*parts); p++)
+  {
+    hash.add(*parts[p]);
+    hash.add("\xff", 1);
+  }
+
+  file_name=directory+"/headers-"+hash.str()+".bin";
+}
+
+/*******************************************************************\
+
+Function: header_cachet::read
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool header_cachet::read(
+  ansi_c_scopet &root_scope,
+  symbol_tablet &symbol_table) const
+{
+  if(file_name.empty())
+    return true;
+
+  std::ifstream in(file_name.c_str(), std::ios::binary);
+
+  if(!in)
+    return true;
+
+  try
+  {
+    irep_table_readert reader;
+    reader.read(in);
+
+    root_scope.compound_counter=reader.word();
+    root_scope.anon_counter=reader.word();
+
+    for(std::size_t names=reader.word(); names!=0; names--)
+    {
+      const irep_idt &name=reader.string();
+      ansi_c_identifiert &identifier=root_scope.name_map[name];
+      identifier.id_class=(ansi_c_id_classt)reader.word();
+      identifier.base_name=reader.string();
+    }
+
+    for(std::size_t symbols=reader.word(); symbols!=0; symbols--)
+    {
+      symbolt symbol;
+      symbol.from_irep(reader.irep());
+      symbol_table.add(symbol);
+    }
+
+    if(!reader.eof())
+      throw "header cache file has bad payload";
+  }
+
+  catch(const char *)
+  {
+    root_scope=ansi_c_scopet();
+    symbol_table.clear();
+    return true;
+  }
+
+  // a corrupt file may have sizes that cannot be allocated
+  catch(const std::bad_alloc &)
+  {
+    root_scope=ansi_c_scopet();
+    symbol_table.clear();
+    return true;
+  }
+
+  catch(const std::length_error &)
+  {
+    root_scope=ansi_c_scopet();
+    symbol_table.clear();
+    return true;
+  }
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: header_cachet::write
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void header_cachet::write(
+  const ansi_c_scopet &root_scope,
+  const symbol_tablet &symbol_table) const
+{
+  if(file_name.empty())
+    return;
+
+  irep_table_writert writer;
+
+  writer.word(root_scope.compound_counter);
+  writer.word(root_scope.anon_counter);
+
+  writer.word(root_scope.name_map.size());
+
+  for(ansi_c_scopet::name_mapt::const_iterator
+      it=root_scope.name_map.begin();
+      it!=root_scope.name_map.end();
+      it++)
+  {
+    writer.string(it->first);
+    writer.word(it->second.id_class);
+    writer.string(it->second.base_name);
+  }
+
+  writer.word(symbol_table.symbols.size());
+
+  forall_symbols(it, symbol_table.symbols)
+  {
+    irept symbol;
+    it->second.to_irep(symbol);
+    writer.irep(symbol);
+  }
+
+  cache_file_writert cache_file(file_name);
+  writer.write(cache_file.out());
+  cache_file.commit();
+}
@@ -0,0 +1,57 @@
+/*******************************************************************\
+
+Module: Caching the Headers a C File Starts With
+
+\*******************************************************************/
+
+#ifndef CPROVER_ANSI_C_HEADER_CACHE_H
+#define CPROVER_ANSI_C_HEADER_CACHE_H
+
+#include <string>
+
+#include "ansi_c_scope.h"
+
+class symbol_tablet;
+
+// Most C files start with the same few headers, which are the larger
+// part of the preprocessed text.  If the environment variable
+// CPROVER_HEADER_CACHE names a directory, the state after the headers
+// and the built-in declarations is kept there: the typechecked symbols,
+// and the names that the parser has seen.  It is keyed on a hash of
+// the preprocessed text of the headers, the built-in declarations and
+// the configuration.  A later file that starts with the same text
+// parses and typechecks only what follows.
+
+class header_cachet
+{
+public:
+  header_cachet();
+
+  inline bool enabled() const
+  {
+    return !directory.empty();
+  }
+
+  // the length of the preprocessed text before the line marker
+  // of the first line that belongs to the file itself, and not
+  // to a header, or std::string::npos if there is no such line
+  static std::size_t header_size(const std::string &preprocessed);
+
+  void set_key(
+    const std::string &built_in,
+    const std::string &headers);
+
+  // true if there is nothing for the key
+  bool read(
+    ansi_c_scopet &root_scope,
+    symbol_tablet &symbol_table) const;
+
+  void write(
+    const ansi_c_scopet &root_scope,
+    const symbol_tablet &symbol_table) const;
+
+protected:
+  std::string directory, file_name;
+};
+
+#endif
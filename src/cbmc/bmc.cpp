@@ -28,6 +28,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <goto-symex/build_goto_trace.h>
 #include <goto-symex/slice.h>
 #include <goto-symex/slice_by_trace.h>
+#include <goto-symex/simplify_equation.h>
 #include <goto-symex/memory_model_sc.h>
 #include <goto-symex/memory_model_tso.h>
 #include <goto-symex/memory_model_pso.h>
@@ -436,6 +437,13 @@ safety_checkert::resultt bmct::run(
       }
     }
 
+    if(options.get_bool_option("simplify"))
+    {
+      unsigned changed=simplify_equation(equation, ns);
+      statistics() << "word-level simplification changed "
+                   << changed << " steps" << eom;
+    }
+
     {
       statistics() << "Generated " << symex.total_vccs
                    << " VCC(s), " << symex.remaining_vccs
@@ -82,16 +82,20 @@ bool cbmc_dimacst::write_dimacs(std::ostream &out)
     if(m_it->second.bvtype==IS_SIGNED ||
        m_it->second.bvtype==IS_UNSIGNED)
     {
-      const boolbv_mapt::literal_mapt &literal_map=m_it->second.literal_map;
+      const boolbv_mapt::map_entryt &map_entry=m_it->second;
       out << "c " << m_it->first;
 
-      for(unsigned i=0; i<literal_map.size(); i++)
-        if(!literal_map[i].is_set)
+      for(unsigned i=0; i<map_entry.width; i++)
+      {
+        literalt l=boolbv_map.get_literal(map_entry, i);
+
+        if(!boolbv_mapt::is_set(l))
           out << " " << "?";
-        else if(literal_map[i].l.is_constant())
-          out << " " << (literal_map[i].l.is_true()?"TRUE":"FALSE");
+        else if(l.is_constant())
+          out << " " << (l.is_true()?"TRUE":"FALSE");
         else
-          out << " " << literal_map[i].l.dimacs();
+          out << " " << l.dimacs();
+      }
 
       out << "\n";
     }
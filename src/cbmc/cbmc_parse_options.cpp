@@ -32,6 +32,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <goto-programs/show_properties.h>
 #include <goto-programs/set_properties.h>
 #include <goto-programs/read_goto_binary.h>
+#include <goto-programs/lazy_goto_binary.h>
 #include <goto-programs/string_abstraction.h>
 #include <goto-programs/string_instrumentation.h>
 #include <goto-programs/loop_ids.h>
@@ -621,8 +622,16 @@ int cbmc_parse_optionst::get_goto_program(
     {
       status() << "Reading GOTO program from file" << eom;
 
-      if(read_goto_binary(cmdline.args[0],
-           symbol_table, goto_functions, get_message_handler()))
+      lazy_goto_binaryt lazy_goto_binary(get_message_handler());
+
+      if(cmdline.isset("lazy-load"))
+      {
+        if(lazy_goto_binary.read(cmdline.args[0],
+             symbol_table, goto_functions))
+          return 6;
+      }
+      else if(read_goto_binary(cmdline.args[0],
+                symbol_table, goto_functions, get_message_handler()))
         return 6;
         
       config.ansi_c.set_from_symbol_table(symbol_table);
@@ -640,6 +649,10 @@ int cbmc_parse_optionst::get_goto_program(
         error() << "The goto binary has no entry point; please complete linking" << eom;
         return 6;
       }
+
+      if(cmdline.isset("lazy-load") &&
+         lazy_goto_binary.load_reachable(entry_point, goto_functions))
+        return 6;
     }
     else if(cmdline.isset("show-parse-tree"))
     {
@@ -1011,6 +1024,9 @@ void cbmc_parse_optionst::help()
     " --show-parse-tree            show parse tree\n"
     " --show-symbol-table          show symbol table\n"
     " --show-goto-functions        show goto program\n"
+    " --lazy-load                  only read the functions of a goto binary\n"
+    "                              that are reachable from the entry point\n"
+    "                              (goto-cc --goto-binary-version 3 or 4)\n"
     " --mm model                   set memory model (default: sc)\n"
     " --arch                       set architecture (default: "
                                    << configt::this_architecture() << ")\n"
@@ -124,6 +124,56 @@ void cpp_typecheckt::show_instantiation_stack(std::ostream &out)
 
 /*******************************************************************\
 
+Function: cpp_typecheckt::remember_instance
+
+  Inputs: the template and the suffix of its arguments,
+          and the symbol of the instance
+
+ Outputs: the symbol
+
+ Purpose: remember the instance if it is complete, i.e., a
+          class with its body, or a function with its value
+
+\*******************************************************************/
+
+const symbolt &cpp_typecheckt::remember_instance(
+  const irep_idt &key,
+  const symbolt &symbol)
+{
+  if(symbol.type.id()==ID_struct ||
+     symbol.value.is_not_nil())
+    instances[key]=symbol.name;
+
+  return symbol;
+}
+
+/*******************************************************************\
+
+Function: cpp_typecheckt::show_instantiation_statistics
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void cpp_typecheckt::show_instantiation_statistics()
+{
+  if(instances.empty())
+    return;
+
+  str << "Template instances: " << instances.size()
+      << ", reused " << instantiation_cache_hits << " times; "
+      << "function bodies of instances typechecked: "
+      << deferred_bodies_typechecked << ", never used: "
+      << deferred_function_bodies.size();
+  statistics_msg();
+}
+
+/*******************************************************************\
+
 Function: cpp_typecheckt::class_template_symbol
 
   Inputs: 
@@ -314,6 +364,19 @@ const symbolt &cpp_typecheckt::instantiate_template(
   
   // produce new symbol name
   std::string suffix=template_suffix(full_template_args);
+
+  // complete already?
+  const irep_idt instance_key=id2string(template_symbol.name)+suffix;
+
+  {
+    instancest::const_iterator c_it=instances.find(instance_key);
+
+    if(c_it!=instances.end())
+    {
+      instantiation_cache_hits++;
+      return lookup(c_it->second);
+    }
+  }
   
   // we need the template scope to see the template parameters
   cpp_scopet *template_scope=
@@ -386,9 +449,9 @@ const symbolt &cpp_typecheckt::instantiate_template(
       // continue if the type is incomplete only
       if(cpp_id.id_class==cpp_idt::CLASS &&
          symb.type.id()==ID_struct)
-        return symb;
+        return remember_instance(instance_key, symb);
       else if(symb.value.is_not_nil())
-        return symb;
+        return remember_instance(instance_key, symb);
     }
 
     cpp_scopes.go_to(scope);
@@ -485,7 +548,7 @@ const symbolt &cpp_typecheckt::instantiate_template(
     const symbolt &new_symb=
       lookup(new_decl.type().get(ID_identifier));
 
-    return new_symb;
+    return remember_instance(instance_key, new_symb);
   }
 
   if(is_template_method)
@@ -539,7 +602,9 @@ const symbolt &cpp_typecheckt::instantiate_template(
       false,
       false);
 
-    return lookup(to_struct_type(symb.type).components().back().get(ID_name));
+    return remember_instance(
+      instance_key,
+      lookup(to_struct_type(symb.type).components().back().get(ID_name)));
   }
 
   // not a class template, not a class template method,
@@ -552,5 +617,5 @@ const symbolt &cpp_typecheckt::instantiate_template(
   const symbolt &symb=
     lookup(new_decl.declarators()[0].get(ID_identifier));
 
-  return symb;
+  return remember_instance(instance_key, symb);
 }
@@ -27,14 +27,14 @@ Function: cpp_token_buffert::LookAhead
 
 int cpp_token_buffert::LookAhead(unsigned offset)
 {
-  assert(current_pos<=token_vector.size());
+  assert(current_pos<=tokens.size());
 
   offset+=current_pos;
 
-  while(offset>=token_vector.size())
+  while(offset>=tokens.size())
     read_token();
 
-  return token_vector[offset]->kind;
+  return tokens[offset].kind;
 }
 
 /*******************************************************************\
@@ -51,11 +51,11 @@ Function: cpp_token_buffert::get_token
 
 int cpp_token_buffert::get_token(cpp_tokent &token)
 {
-  assert(current_pos<=token_vector.size());
+  assert(current_pos<=tokens.size());
 
-  if(token_vector.size()==current_pos) read_token();
+  if(tokens.size()==current_pos) read_token();
 
-  token=*token_vector[current_pos];
+  token=tokens[current_pos];
 
   current_pos++;
 
@@ -76,11 +76,11 @@ Function: cpp_token_buffert::get_token
 
 int cpp_token_buffert::get_token()
 {
-  assert(current_pos<=token_vector.size());
+  assert(current_pos<=tokens.size());
 
-  if(token_vector.size()==current_pos) read_token();
+  if(tokens.size()==current_pos) read_token();
   
-  int kind=token_vector[current_pos]->kind;
+  int kind=tokens[current_pos].kind;
 
   current_pos++;
 
@@ -101,14 +101,14 @@ Function: cpp_token_buffert::LookAhead
 
 int cpp_token_buffert::LookAhead(unsigned offset, cpp_tokent &token)
 {
-  assert(current_pos<=token_vector.size());
+  assert(current_pos<=tokens.size());
 
   offset+=current_pos;
 
-  while(offset>=token_vector.size())
+  while(offset>=tokens.size())
     read_token();
 
-  token=*token_vector[offset];
+  token=tokens[offset];
 
   return token.kind;
 }
@@ -130,28 +130,28 @@ extern char *yyansi_ctext;
 
 void cpp_token_buffert::read_token()
 {
+  if(tokens.empty())
+    tokens.reserve(4096);
+
   tokens.push_back(cpp_tokent());
-  token_vector.push_back(--tokens.end());
+  cpp_tokent &token=tokens.back();
 
   int kind;
   
   ansi_c_parser.stack.clear();
   kind=yyansi_clex();
-  tokens.back().text=yyansi_ctext;
+  token.text=yyansi_ctext;
   if(ansi_c_parser.stack.size()==1)
   {
-    tokens.back().data=ansi_c_parser.stack.front();
-    tokens.back().line_no=ansi_c_parser.get_line_no();
-    tokens.back().filename=ansi_c_parser.get_file();
+    token.data.swap(ansi_c_parser.stack.front());
+    token.line_no=ansi_c_parser.get_line_no();
+    token.filename=ansi_c_parser.get_file();
   }  
 
-  //std::cout << "TOKEN: " << kind << " " << tokens.back().text << std::endl;
-
-  tokens.back().kind=kind;
-  tokens.back().pos=token_vector.size()-1;
+  //std::cout << "TOKEN: " << kind << " " << token.text << std::endl;
 
-  //std::cout << "II: " << token_vector.back()->kind << std::endl;
-  //std::cout << "I2: " << token_vector.size() << std::endl;
+  token.kind=kind;
+  token.pos=tokens.size()-1;
 }
 
 /*******************************************************************\
@@ -9,6 +9,8 @@ Author: Daniel Kroening, kroening@cs.cmu.edu
 #ifndef CPROVER_CPP_TOKEN_BUFFER_H
 #define CPROVER_CPP_TOKEN_BUFFER_H
 
+#include <vector>
+
 #include "cpp_token.h"
 
 class cpp_token_buffert
@@ -31,7 +33,6 @@ public:
   void clear()
   {
     tokens.clear();
-    token_vector.clear();
     current_pos=0;
   }
 
@@ -43,11 +44,12 @@ public:
   }
   
 protected:
-  typedef std::list<cpp_tokent> tokenst;
+  // All tokens read so far, in one array, and the parser's position
+  // is an index into it: backtracking is setting the index, and there
+  // is no per-token allocation or pointer chasing.
+  typedef std::vector<cpp_tokent> tokenst;
   tokenst tokens;
   
-  std::vector<tokenst::iterator> token_vector;
-  
   post current_pos;
   
   // get another token from lexer
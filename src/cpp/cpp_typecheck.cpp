@@ -13,6 +13,7 @@ Author: Daniel Kroening, kroening@cs.cmu.edu
 #include <util/i2string.h>
 #include <util/source_location.h>
 #include <util/symbol.h>
+#include <util/find_symbols.h>
 
 #include <linking/zero_initializer.h>
 #include <ansi-c/c_typecast.h>
@@ -139,6 +140,8 @@ void cpp_typecheckt::typecheck()
 
   do_not_typechecked();
 
+  show_instantiation_statistics();
+
   clean_up();
 }
 
@@ -327,10 +330,44 @@ void cpp_typecheckt::do_not_typechecked()
 {
   bool cont;
 
+  // what is used by the symbols typechecked so far
+  find_symbols_sett used, scanned;
+
   do
   {
     cont = false;
 
+    forall_symbols(s_it, symbol_table.symbols)
+    {
+      const symbolt &symbol=s_it->second;
+
+      if(symbol.value.id()!="cpp_not_typechecked" &&
+         deferred_function_bodies.find(symbol.name)==
+         deferred_function_bodies.end() &&
+         scanned.insert(symbol.name).second)
+        find_symbols(symbol.value, used);
+    }
+
+    for(find_symbols_sett::const_iterator
+        it=used.begin();
+        it!=used.end();
+        it++)
+    {
+      deferred_function_bodiest::iterator d_it=
+        deferred_function_bodies.find(*it);
+
+      if(d_it==deferred_function_bodies.end())
+        continue;
+
+      // typechecking may add more
+      function_bodyt function_body=d_it->second;
+      deferred_function_bodies.erase(d_it);
+
+      typecheck_function_body(function_body);
+      deferred_bodies_typechecked++;
+      cont=true;
+    }
+
     Forall_symbols(s_it, symbol_table.symbols)
     {
       symbolt &symbol=s_it->second;
@@ -370,6 +407,13 @@ void cpp_typecheckt::do_not_typechecked()
     if(symbol.value.id()=="cpp_not_typechecked")
       symbol.value.make_nil();
   }
+
+  // never used, and never typechecked
+  for(deferred_function_bodiest::iterator
+      it=deferred_function_bodies.begin();
+      it!=deferred_function_bodies.end();
+      it++)
+    it->second.function_symbol->value.make_nil();
 }
 
 /*******************************************************************\
@@ -16,6 +16,7 @@ Author: Daniel Kroening, kroening@cs.cmu.edu
 
 #include <util/std_code.h>
 #include <util/std_types.h>
+#include <util/hash_cont.h>
 
 #include <ansi-c/c_typecheck_base.h>
 
@@ -48,8 +49,10 @@ public:
     message_handlert &message_handler):
     c_typecheck_baset(_symbol_table, _module, message_handler),
     cpp_parse_tree(_cpp_parse_tree),
+    instantiation_cache_hits(0),
     template_counter(0),
     anon_counter(0),
+    deferred_bodies_typechecked(0),
     disable_access_control(false)
   {
   }
@@ -63,8 +66,10 @@ public:
     c_typecheck_baset(_symbol_table1, _symbol_table2,
                       _module, message_handler),
     cpp_parse_tree(_cpp_parse_tree),
+    instantiation_cache_hits(0),
     template_counter(0),
     anon_counter(0),
+    deferred_bodies_typechecked(0),
     disable_access_control(false)
   {
   }
@@ -225,6 +230,18 @@ protected:
     const source_locationt &source_location,
     const symbol_typet &type);
 
+  // the complete instances, from the template and the
+  // suffix of its arguments to the symbol of the instance
+  typedef hash_map_cont<irep_idt, irep_idt, irep_id_hash> instancest;
+  instancest instances;
+  unsigned instantiation_cache_hits;
+
+  const symbolt &remember_instance(
+    const irep_idt &key,
+    const symbolt &symbol);
+
+  void show_instantiation_statistics();
+
   unsigned template_counter;
   unsigned anon_counter;
 
@@ -345,6 +362,15 @@ protected:
   
   typedef std::list<function_bodyt> function_bodiest;
   function_bodiest function_bodies;
+
+  // The bodies of functions that come from instantiating a
+  // template are only typechecked once they are used, see
+  // do_not_typechecked.
+  typedef std::map<irep_idt, function_bodyt> deferred_function_bodiest;
+  deferred_function_bodiest deferred_function_bodies;
+  unsigned deferred_bodies_typechecked;
+
+  void typecheck_function_body(function_bodyt &function_body);
   
   void add_function_body(symbolt *_function_symbol)
   {
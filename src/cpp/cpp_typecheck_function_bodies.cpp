@@ -45,10 +45,42 @@ void cpp_typecheckt::typecheck_function_bodies()
     if(body.is_not_nil() &&
        !body.is_zero())
     {
-      convert_function(function_symbol);
+      // from a template instantiation? do once used
+      if(!instantiation_stack.empty())
+        deferred_function_bodies.insert(
+          std::make_pair(
+            function_symbol.name,
+            function_bodyt(
+              &function_symbol, template_map, instantiation_stack)));
+      else
+        convert_function(function_symbol);
     }
   }
 
   old_instantiation_stack.swap(instantiation_stack);
 }
 
+/*******************************************************************\
+
+Function: cpp_typecheckt::typecheck_function_body
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: typecheck a body that has been deferred, in the
+          template context it was deferred in
+
+\*******************************************************************/
+
+void cpp_typecheckt::typecheck_function_body(function_bodyt &function_body)
+{
+  template_map.swap(function_body.template_map);
+  instantiation_stack.swap(function_body.instantiation_stack);
+
+  convert_function(*function_body.function_symbol);
+
+  template_map.swap(function_body.template_map);
+  instantiation_stack.swap(function_body.instantiation_stack);
+}
+
@@ -8,11 +8,13 @@ Date: June 2006
 
 \*******************************************************************/
 
+#include <cassert>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <cstdlib>
 #include <algorithm>
+#include <vector>
 
 #include <util/config.h>
 #include <util/tempdir.h>
@@ -32,6 +34,8 @@ Date: June 2006
 #include <goto-programs/goto_convert_functions.h>
 #include <goto-programs/goto_inline.h>
 #include <goto-programs/read_goto_binary.h>
+#include <goto-programs/read_bin_goto_object.h>
+#include <goto-programs/ar_reader.h>
 #include <goto-programs/write_goto_binary.h>
 
 #include <langapi/mode.h>
@@ -40,6 +44,7 @@ Date: June 2006
 
 #include "get_base_name.h"
 #include "compile.h"
+#include "link_cache.h"
 
 #define DOTGRAPHSETTINGS  "color=black;" \
                           "orientation=portrait;" \
@@ -57,6 +62,8 @@ Date: June 2006
     defined(__CYGWIN__) || \
     defined(__MACH__)
 #include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 #endif
 
 #ifdef _WIN32
@@ -104,7 +111,9 @@ bool compilet::doit()
 
   // Work through the given source files
 
-  if(source_files.empty() && object_files.empty())
+  if(source_files.empty() &&
+     object_files.empty() &&
+     archive_members.empty())
   {
     error() << "no input files" << eom;
     return true;
@@ -186,115 +195,249 @@ bool compilet::add_input_file(const std::string &file_name)
   }
   else if(ext=="a")
   {
-    #ifdef _WIN32
-    char td[MAX_PATH+1];
-    #else
-    char td[] = "goto-cc.XXXXXX";
-    #endif
+    if(add_archive(file_name))
+      return true;
+  }
+  else if(is_goto_binary(file_name))
+    object_files.push_back(file_name);
+  else
+  {
+    // unknown extension, not a goto binary, will silently ignore
+  }
 
-    std::string tstr=get_temporary_directory(td);
+  return false;
+}
 
-    if(tstr=="")
-    {
-      error() << "Cannot create temporary directory" << eom;
-      return true;
-    }
+/*******************************************************************\
 
-    tmp_dirs.push_back(tstr);
-    std::stringstream cmd("");
-    if(chdir(tmp_dirs.back().c_str())!=0)
-    {
-      error() << "Cannot switch to temporary directory" << eom;
-      return true;
-    }
+Function: compilet::add_archive
 
-    // unpack now
-    #ifdef _WIN32
-    if(file_name[0]!='/' && file_name[1]!=':')
-    #else
-    if(file_name[0]!='/')
-    #endif
-    {
-      cmd << "ar x " <<
-      #ifdef _WIN32
-        working_directory << "\\" << file_name;
-      #else
-        working_directory << "/" << file_name;
-      #endif
-    }
-    else
-    {
-      cmd << "ar x " << file_name;
-    }
-    
-    FILE *stream;
+  Inputs: file name of a static library
 
-    stream=popen(cmd.str().c_str(), "r");
-    pclose(stream);
-    
-    cmd.clear();
-    cmd.str("");
-    
-    // add the files from "ar t"
-    #ifdef _WIN32
-    if(file_name[0]!='/' && file_name[1]!=':')
-    #else
-    if(file_name[0]!='/')
-    #endif
-    {
-      cmd << "ar t " <<
-      #ifdef _WIN32
-        working_directory << "\\" << file_name;
-      #else
-        working_directory << "/" << file_name;
-      #endif
-    }
-    else
+ Outputs: false on success, true on error.
+
+ Purpose: reads the goto binaries in the library, without extracting
+          them; these are linked later on, if they are needed.
+
+\*******************************************************************/
+
+bool compilet::add_archive(const std::string &file_name)
+{
+  #ifdef _MSC_VER
+  std::ifstream in(widen(file_name).c_str(), std::ios::binary);
+  #else
+  std::ifstream in(file_name.c_str(), std::ios::binary);
+  #endif
+
+  if(!in)
+  {
+    error() << "failed to open archive `" << file_name << "'" << eom;
+    return true;
+  }
+
+  try
+  {
+    ar_readert ar_reader(in);
+
+    for(ar_readert::memberst::const_iterator
+        m_it=ar_reader.members.begin();
+        m_it!=ar_reader.members.end();
+        m_it++)
     {
-      cmd << "ar t " << file_name;
+      archive_membert member;
+      member.name=file_name+"("+m_it->name+")";
+      member.archive=file_name;
+      member.member=*m_it;
+
+      std::istringstream member_in(ar_reader.get_contents(*m_it));
+      if(!is_goto_binary(member_in))
+        continue;
+
+      // we need to know what the member defines, which is
+      // in the symbols
+      symbol_tablet temp_symbol_table;
+
+      member_in.clear();
+      member_in.seekg(0);
+
+      if(read_goto_binary_symbols(member_in, member.name,
+                                  temp_symbol_table))
+        return true;
+
+      forall_symbols(s_it, temp_symbol_table.symbols)
+        if(!s_it->second.is_type &&
+           !s_it->second.is_file_local &&
+           is_definition(s_it->second))
+          member.definitions.insert(s_it->first);
+
+      archive_members.push_back(member);
     }
+  }
 
-    stream=popen(cmd.str().c_str(), "r");
+  catch(const char *s)
+  {
+    error() << file_name << ": " << s << eom;
+    return true;
+  }
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: compilet::read_goto_binary_symbols
+
+  Inputs: a goto binary
+
+ Outputs: true on error, false otherwise
+
+ Purpose: reads the symbols of a goto binary, and the function
+          bodies only where the format has no index to skip them
+
+\*******************************************************************/
+
+bool compilet::read_goto_binary_symbols(
+  std::istream &in,
+  const std::string &file_name,
+  symbol_tablet &dest)
+{
+  char hdr[4];
+  in.read(hdr, 4);
+  bool is_gbf=
+    in && hdr[0]==0x7f && hdr[1]=='G' && hdr[2]=='B' && hdr[3]=='F';
+  in.clear();
+  in.seekg(0);
+
+  goto_functionst temp_functions;
+
+  if(!is_gbf)
+    return read_goto_binary(
+      in, file_name, dest, temp_functions, get_message_handler());
+
+  goto_binary_indext index;
+
+  return read_bin_goto_object(
+    in, file_name, dest, temp_functions, get_message_handler(), &index);
+}
+
+/*******************************************************************\
+
+Function: compilet::is_definition
+
+  Inputs: a symbol
+
+ Outputs: true if the symbol is defined, rather than declared
+
+ Purpose:
+
+\*******************************************************************/
+
+bool compilet::is_definition(const symbolt &symbol)
+{
+  if(symbol.type.id()==ID_code)
+    return symbol.value.is_not_nil();
+  else
+    return !symbol.is_extern;
+}
+
+/*******************************************************************\
+
+Function: compilet::link_archive_members
+
+  Inputs: none
+
+ Outputs: true on error, false otherwise
+
+ Purpose: when linking an executable, links the members of
+          static libraries that define symbols that are declared
+          but not defined, or the entry point, until there are no
+          more such members, as a linker does; otherwise, links
+          all members.
+
+\*******************************************************************/
+
+bool compilet::link_archive_members(goto_functionst &functions)
+{
+  // a library or a partial link keeps everything
+  bool link_all=mode!=COMPILE_LINK_EXECUTABLE;
+
+  // nothing declares the entry point, the C library's
+  // start-up code refers to it instead
+  irep_idt entry_point_name;
+
+  if(mode==COMPILE_LINK_EXECUTABLE &&
+     symbol_table.symbols.find(goto_functionst::entry_point())==
+     symbol_table.symbols.end())
+    entry_point_name=config.main!=""?config.main:"main";
+
+  bool progress=true;
+
+  while(progress)
+  {
+    progress=false;
 
-    if(stream!=NULL)
+    for(std::list<archive_membert>::iterator
+        m_it=archive_members.begin();
+        m_it!=archive_members.end();
+        ) // no m_it++
     {
-      std::string line;
-      int ch; // fgetc returns an int, not char
-      while((ch=fgetc(stream))!=EOF)
+      bool needed=link_all;
+
+      for(std::set<irep_idt>::const_iterator
+          d_it=m_it->definitions.begin();
+          d_it!=m_it->definitions.end() && !needed;
+          d_it++)
       {
-        if(ch!='\n')
-        {
-          line+=(char)ch;
-        }
+        symbol_tablet::symbolst::const_iterator s_it=
+          symbol_table.symbols.find(*d_it);
+
+        if(s_it==symbol_table.symbols.end())
+          needed=*d_it==entry_point_name;
         else
-        {
-          std::string t;
-          #ifdef _WIN32
-          t = tmp_dirs.back() + '\\' + line;
-          #else
-          t = tmp_dirs.back() + '/' + line;
-          #endif
+          needed=!is_definition(s_it->second);
+      }
 
-          if(is_goto_binary(t))
-            object_files.push_back(t);
+      if(!needed)
+      {
+        m_it++;
+        continue;
+      }
 
-          line = "";
-        }
+      print(8, "Reading: " + m_it->name);
+
+      #ifdef _MSC_VER
+      std::ifstream archive_in(
+        widen(m_it->archive).c_str(), std::ios::binary);
+      #else
+      std::ifstream archive_in(m_it->archive.c_str(), std::ios::binary);
+      #endif
+
+      symbol_tablet temp_symbol_table;
+      goto_functionst temp_functions;
+
+      try
+      {
+        std::istringstream in(
+          ar_readert::get_contents(archive_in, m_it->member));
+
+        if(read_goto_binary(in, m_it->name,
+                            temp_symbol_table, temp_functions,
+                            get_message_handler()))
+          return true;
       }
 
-      pclose(stream);
-    }
+      catch(const char *s)
+      {
+        error() << m_it->archive << ": " << s << eom;
+        return true;
+      }
 
-    cmd.str("");
+      if(link_object(temp_symbol_table, temp_functions, functions))
+        return true;
 
-    if(chdir(working_directory.c_str())!=0)
-      error() << "Could not change back to working directory" << eom;
-  }
-  else if(is_goto_binary(file_name))
-    object_files.push_back(file_name);
-  else
-  {
-    // unknown extension, not a goto binary, will silently ignore
+      m_it=archive_members.erase(m_it);
+      progress=true;
+    }
   }
 
   return false;
@@ -399,14 +542,12 @@ bool compilet::link()
   convert_symbols(compiled_functions);
 
   // parse object files
-  while(object_files.size()>0)
-  {
-    std::string file_name=object_files.front();
-    object_files.pop_front();
+  if(read_objects(compiled_functions))
+    return true;
 
-    if(read_object(file_name, compiled_functions))
-      return true;
-  }
+  // and what is needed from static libraries
+  if(link_archive_members(compiled_functions))
+    return true;
 
   // produce entry point?
   
@@ -427,6 +568,75 @@ bool compilet::link()
 
 /*******************************************************************\
 
+Function: compilet::read_objects
+
+  Inputs: the functions to link the object files into
+
+ Outputs: true on error, false otherwise
+
+ Purpose: reads and links the object files in order, starting
+          from what the link cache has for the unchanged ones
+
+\*******************************************************************/
+
+bool compilet::read_objects(goto_functionst &functions)
+{
+  link_cachet link_cache(get_message_handler());
+
+  // the cache only knows about links that start from nothing
+  if(!link_cache.enabled() ||
+     object_files.empty() ||
+     !symbol_table.symbols.empty() ||
+     function_body_count(functions)!=0)
+  {
+    while(object_files.size()>0)
+    {
+      std::string file_name=object_files.front();
+      object_files.pop_front();
+
+      if(read_object(file_name, functions))
+        return true;
+    }
+
+    return false;
+  }
+
+  std::vector<std::string> files(object_files.begin(), object_files.end());
+  object_files.clear();
+
+  std::string output=output_file_executable;
+  if(!output.empty() && output[0]!='/')
+    output=working_directory+"/"+output;
+
+  if(link_cache.begin(output, files))
+  {
+    for(std::size_t i=0; i<files.size(); i++)
+      if(read_object(files[i], functions))
+        return true;
+
+    return false;
+  }
+
+  functions.clear();
+
+  for(std::size_t i=link_cache.restore(symbol_table, functions);
+      i<files.size();
+      i++)
+  {
+    link_cache.checkpoint(i, symbol_table, functions);
+
+    if(read_object(files[i], functions))
+      return true;
+  }
+
+  link_cache.checkpoint(files.size(), symbol_table, functions);
+  link_cache.end();
+
+  return false;
+}
+
+/*******************************************************************\
+
 Function: compilet::compile
 
   Inputs: none
@@ -440,6 +650,23 @@ Function: compilet::compile
 
 bool compilet::compile()
 {
+  #ifndef _WIN32
+  // With -c -o and several sources, every object goes to the same
+  // file, one after the other.  In parallel, they would be written
+  // at the same time.
+  bool one_output_file=
+    (mode==COMPILE_ONLY || mode==ASSEMBLE_ONLY) &&
+    output_file_object!="";
+
+  if(number_of_jobs>1 &&
+     source_files.size()>1 &&
+     mode!=PREPROCESS_ONLY &&
+     !one_output_file &&
+     std::find(source_files.begin(), source_files.end(), "-")==
+       source_files.end())
+    return compile_parallel();
+  #endif
+
   while(!source_files.empty())
   {
     std::string file_name=source_files.front();
@@ -480,6 +707,134 @@ bool compilet::compile()
 
 /*******************************************************************\
 
+Function: compilet::compile_parallel
+
+  Inputs: none
+
+ Outputs: true on error, false otherwise
+
+ Purpose: compiles each source file in a process of its own, with
+          up to number_of_jobs processes at a time. Each process
+          writes an object file; when linking, these are temporary
+          and are read back in the order of the source files, so
+          the result is the same as when compiling sequentially.
+
+\*******************************************************************/
+
+#ifndef _WIN32
+bool compilet::compile_parallel()
+{
+  std::vector<std::string> sources(source_files.begin(), source_files.end());
+  std::vector<std::string> objects(sources.size());
+  source_files.clear();
+
+  bool link_objects=(mode!=COMPILE_ONLY && mode!=ASSEMBLE_ONLY);
+
+  if(link_objects)
+  {
+    char td[] = "goto-cc.XXXXXX";
+    std::string tstr=get_temporary_directory(td);
+
+    if(tstr=="")
+    {
+      error() << "Cannot create temporary directory" << eom;
+      return true;
+    }
+
+    tmp_dirs.push_back(tstr);
+
+    for(std::size_t i=0; i<sources.size(); i++)
+    {
+      std::ostringstream object;
+      object << tstr << '/' << i << '.' << object_file_extension;
+      objects[i]=object.str();
+    }
+  }
+  else
+  {
+    // compile() does not get here with a single output file
+    assert(output_file_object=="");
+
+    for(std::size_t i=0; i<sources.size(); i++)
+      objects[i]=get_base_name(sources[i]) + "." + object_file_extension;
+  }
+
+  // children inherit the buffers
+  std::cout.flush();
+  std::cerr.flush();
+
+  std::size_t next=0, running=0;
+  bool error_found=false;
+
+  while(running>0 || (next<sources.size() && !error_found))
+  {
+    if(next<sources.size() && running<number_of_jobs && !error_found)
+    {
+      pid_t pid=fork();
+
+      if(pid==-1)
+      {
+        error() << "failed to fork" << eom;
+        error_found=true;
+        continue;
+      }
+
+      if(pid==0)
+      {
+        // the child compiles one file
+        const std::string &file_name=sources[next];
+
+        if(echo_file_name)
+          status() << file_name << eom;
+
+        bool r=parse_source(file_name);
+
+        if(!r)
+        {
+          convert_symbols(compiled_functions);
+          r=write_object_file(objects[next], symbol_table, compiled_functions);
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+
+        // no destructors, the temporary files belong to the parent
+        _exit(r?1:0);
+      }
+
+      next++;
+      running++;
+    }
+    else
+    {
+      int status;
+
+      if(wait(&status)==-1)
+      {
+        error() << "failed to wait for compiler process" << eom;
+        return true;
+      }
+
+      running--;
+
+      if(!WIFEXITED(status) || WEXITSTATUS(status)!=0)
+        error_found=true;
+    }
+  }
+
+  if(error_found)
+    return true;
+
+  // link the objects first, as if the sources had been compiled here
+  if(link_objects)
+    object_files.insert(object_files.begin(), objects.begin(), objects.end());
+
+  return false;
+}
+#endif
+
+/*******************************************************************\
+
 Function: compilet::parse
 
   Inputs: file_name
@@ -685,7 +1040,8 @@ bool compilet::write_bin_object_file(
     return true;
   }
 
-  if(write_goto_binary(outfile, lsymbol_table, functions))
+  if(write_goto_binary(
+       outfile, lsymbol_table, functions, goto_binary_version))
     return true;
 
   unsigned cnt=function_body_count(functions);
@@ -752,7 +1108,27 @@ bool compilet::read_object(
 
   if(read_goto_binary(file_name, temp_symbol_table, temp_functions, *message_handler))
     return true;
-  
+
+  return link_object(temp_symbol_table, temp_functions, functions);
+}
+
+/*******************************************************************\
+
+Function: compilet::link_object
+
+  Inputs: the symbols and functions of an object
+
+ Outputs: true on error, false otherwise
+
+ Purpose: links an object that has been read
+
+\*******************************************************************/
+
+bool compilet::link_object(
+  symbol_tablet &temp_symbol_table,
+  goto_functionst &temp_functions,
+  goto_functionst &functions)
+{
   std::set<irep_idt> seen_modes;
 
   for(symbol_tablet::symbolst::const_iterator
@@ -807,6 +1183,8 @@ compilet::compilet(cmdlinet &_cmdline):
 {
   mode=COMPILE_LINK_EXECUTABLE;
   echo_file_name=false;
+  number_of_jobs=1;
+  goto_binary_version=GOTO_BINARY_VERSION;
   working_directory=get_current_working_directory();
 }
 
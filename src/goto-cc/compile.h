@@ -16,6 +16,7 @@ Date: June 2006
 
 #include <langapi/language_ui.h>
 #include <goto-programs/goto_functions.h>
+#include <goto-programs/ar_reader.h>
 
 class compilet:public language_uit
 {
@@ -23,6 +24,8 @@ public:
   namespacet ns;
   goto_functionst compiled_functions;
   bool echo_file_name;
+  unsigned number_of_jobs;
+  unsigned goto_binary_version;
   std::string working_directory;
   std::string override_language;
   
@@ -39,6 +42,18 @@ public:
   std::list<std::string> object_files;
   std::list<std::string> libraries;
   std::list<std::string> tmp_dirs;
+
+  // goto binaries in static libraries, which are read when
+  // they turn out to be needed
+  struct archive_membert
+  {
+    std::string name;
+    std::string archive;
+    ar_readert::membert member;
+    std::set<irep_idt> definitions;
+  };
+
+  std::list<archive_membert> archive_members;
   std::list<irep_idt> seen_modes;
 
   std::string object_file_extension;
@@ -49,6 +64,7 @@ public:
   ~compilet();
   
   bool add_input_file(const std::string &);
+  bool add_archive(const std::string &);
   bool find_library(const std::string &);
   bool is_elf_file(const std::string &);
 
@@ -56,10 +72,13 @@ public:
   bool parse_stdin();
   bool doit();
   bool compile();
+  bool compile_parallel();
   bool link();
 
   bool parse_source(const std::string &);
   bool read_object(const std::string &, goto_functionst &);
+  bool read_objects(goto_functionst &);
+  bool link_archive_members(goto_functionst &);
 
   bool write_object_file( const std::string &, const symbol_tablet &, 
                           goto_functionst &);
@@ -70,6 +89,18 @@ protected:
   cmdlinet &cmdline;
   
   unsigned function_body_count(const goto_functionst &);
+
+  bool link_object(
+    symbol_tablet &temp_symbol_table,
+    goto_functionst &temp_functions,
+    goto_functionst &functions);
+
+  static bool is_definition(const symbolt &);
+
+  bool read_goto_binary_symbols(
+    std::istream &,
+    const std::string &file_name,
+    symbol_tablet &);
   
   void add_compiler_specific_defines(class configt &config) const;
 
@@ -51,6 +51,8 @@ const char *gcc_options_with_separated_argument[]=
 {
   "--verbosity", // non-gcc
   "--function",  // non-gcc
+  "--jobs", // non-gcc
+  "--goto-binary-version", // non-gcc
   "-aux-info",
   "--param", // Apple only
   "-imacros",
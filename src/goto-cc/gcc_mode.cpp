@@ -185,6 +185,21 @@ bool gcc_modet::doit()
   // determine actions to be undertaken
   compilet compiler(cmdline);  
   compiler.ui_message_handler.set_verbosity(verbosity);
+
+  if(cmdline.isset("jobs"))
+    compiler.number_of_jobs=unsafe_string2unsigned(cmdline.get_value("jobs"));
+
+  if(cmdline.isset("goto-binary-version"))
+  {
+    compiler.goto_binary_version=
+      unsafe_string2unsigned(cmdline.get_value("goto-binary-version"));
+
+    if(compiler.goto_binary_version<2 || compiler.goto_binary_version>4)
+    {
+      error() << "goto binary version must be 2, 3 or 4" << eom;
+      return true;
+    }
+  }
   
   if(act_as_ld)
     compiler.mode=compilet::LINK_LIBRARY;
@@ -434,7 +449,8 @@ int gcc_modet::preprocess(
     {
       // ignore
     }
-    else if(it->arg=="--function" || it->arg=="--verbosity")
+    else if(it->arg=="--function" || it->arg=="--verbosity" ||
+            it->arg=="--jobs" || it->arg=="--goto-binary-version")
     {
       // ignore here
       skip_next=true;
@@ -609,7 +625,8 @@ int gcc_modet::gcc_hybrid_binary()
       // skip
       skip_next=false;
     }
-    else if(it->arg=="--verbosity")
+    else if(it->arg=="--verbosity" || it->arg=="--jobs" ||
+            it->arg=="--goto-binary-version")
     {
       // ignore here
       skip_next=true;
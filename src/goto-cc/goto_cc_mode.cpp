@@ -83,6 +83,8 @@ void goto_cc_modet::help()
   "Usage:                       Purpose:\n"
   "\n"
   " --verbosity #               verbosity level\n"
+  " --jobs #                    compile up to # source files in parallel\n"
+  " --goto-binary-version #     format of the goto binaries written (2 to 4)\n"
   "\n";
 }
 
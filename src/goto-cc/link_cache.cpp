@@ -0,0 +1,300 @@
+/*******************************************************************\
+
+Module: Reusing the Linking of Unchanged Object Files
+
+\*******************************************************************/
+
+#include <cassert>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include <util/cache_file.h>
+#include <util/symbol_table.h>
+#include <util/unicode.h>
+
+#include <goto-programs/goto_functions.h>
+#include <goto-programs/read_goto_binary.h>
+#include <goto-programs/write_goto_binary.h>
+
+#include <cbmc/version.h>
+
+#include "link_cache.h"
+
+// the checkpoints are read far more often than they are
+// written, and version 4 is the fastest to read
+#define CACHE_GOTO_BINARY_VERSION 4
+
+/*******************************************************************\
+
+Function: link_cachet::link_cachet
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+link_cachet::link_cachet(message_handlert &_message_handler):
+  messaget(_message_handler),
+  restored(0)
+{
+  const char *cache_dir=getenv("CPROVER_LINK_CACHE");
+
+  if(cache_dir!=NULL)
+    directory=cache_dir;
+}
+
+/*******************************************************************\
+
+Function: link_cachet::checkpoint_file
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+std::string link_cachet::checkpoint_file(const std::string &hash) const
+{
+  return directory+"/link-"+hash+".gb";
+}
+
+/*******************************************************************\
+
+Function: link_cachet::begin
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool link_cachet::begin(
+  const std::string &output,
+  const std::vector<std::string> &object_files)
+{
+  if(!enabled())
+    return true;
+
+  {
+    fnv_hasht output_hash;
+    output_hash.add(output);
+    manifest_file=directory+"/link-"+output_hash.str()+".manifest";
+  }
+
+  // the hash of each prefix of the objects, starting with
+  // what else the result depends on
+  std::ostringstream key;
+  key << "goto-cc " CBMC_VERSION " " << CACHE_GOTO_BINARY_VERSION << '\n';
+
+  fnv_hasht hash;
+  hash.add(key.str());
+
+  hashes.clear();
+  hashes.reserve(object_files.size()+1);
+  hashes.push_back(hash.str());
+
+  std::vector<char> buffer(1<<16);
+
+  for(std::vector<std::string>::const_iterator
+      it=object_files.begin();
+      it!=object_files.end();
+      it++)
+  {
+    #ifdef _MSC_VER
+    std::ifstream in(widen(*it).c_str(), std::ios::binary);
+    #else
+    std::ifstream in(it->c_str(), std::ios::binary);
+    #endif
+
+    if(!in)
+      return true;
+
+    while(in)
+    {
+      in.read(&buffer.front(), buffer.size());
+      hash.add(&buffer.front(), in.gcount());
+    }
+
+    // the boundary between two objects
+    hash.add("\n", 1);
+
+    hashes.push_back(hash.str());
+  }
+
+  // what we did the last time
+  previous_hashes.clear();
+  previous_checkpoints.clear();
+
+  std::ifstream manifest(manifest_file.c_str());
+  std::string line;
+
+  while(std::getline(manifest, line))
+  {
+    if(line.size()>2 && line[0]=='h' && line[1]==' ')
+      previous_hashes.push_back(line.substr(2));
+    else if(line.size()>2 && line[0]=='c' && line[1]==' ')
+      previous_checkpoints.push_back(line.substr(2));
+  }
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: link_cachet::restore
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+std::size_t link_cachet::restore(
+  symbol_tablet &symbol_table,
+  goto_functionst &goto_functions)
+{
+  restored=0;
+
+  for(std::size_t k=hashes.size()-1; k>0; k--)
+  {
+    const std::string file_name=checkpoint_file(hashes[k]);
+
+    if(!is_goto_binary(file_name))
+      continue;
+
+    null_message_handlert null_message_handler;
+
+    if(read_goto_binary(
+         file_name, symbol_table, goto_functions, null_message_handler))
+    {
+      // start over
+      symbol_table.clear();
+      goto_functions.clear();
+      continue;
+    }
+
+    status() << "Reusing the linking of " << k << " of "
+             << hashes.size()-1 << " object files" << eom;
+
+    checkpoints.push_back(hashes[k]);
+    restored=k;
+    break;
+  }
+
+  return restored;
+}
+
+/*******************************************************************\
+
+Function: link_cachet::checkpoint
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void link_cachet::checkpoint(
+  std::size_t index,
+  const symbol_tablet &symbol_table,
+  const goto_functionst &goto_functions)
+{
+  assert(index<hashes.size());
+
+  if(index==0 || index==restored)
+    return;
+
+  // the end, or the first object that differs from the last time
+  bool last=index+1==hashes.size();
+  bool first_change=
+    index<previous_hashes.size() &&
+    previous_hashes[index]==hashes[index] &&
+    (index+1>=previous_hashes.size() ||
+     index+1>=hashes.size() ||
+     previous_hashes[index+1]!=hashes[index+1]);
+
+  if(!last && !first_change)
+    return;
+
+  const std::string file_name=checkpoint_file(hashes[index]);
+  checkpoints.push_back(hashes[index]);
+
+  if(is_goto_binary(file_name))
+    return; // from some other output
+
+  cache_file_writert cache_file(file_name);
+
+  if(write_goto_binary(
+       cache_file.out(), symbol_table, goto_functions,
+       CACHE_GOTO_BINARY_VERSION) ||
+     cache_file.commit())
+  {
+    warning() << "failed to write the link cache" << eom;
+    checkpoints.pop_back();
+  }
+}
+
+/*******************************************************************\
+
+Function: link_cachet::end
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void link_cachet::end()
+{
+  cache_file_writert cache_file(manifest_file);
+  std::ostream &out=cache_file.out();
+
+  for(hashest::const_iterator
+      it=hashes.begin();
+      it!=hashes.end();
+      it++)
+    out << "h " << *it << '\n';
+
+  for(hashest::const_iterator
+      it=checkpoints.begin();
+      it!=checkpoints.end();
+      it++)
+    out << "c " << *it << '\n';
+
+  for(hashest::const_iterator
+      it=previous_checkpoints.begin();
+      it!=previous_checkpoints.end();
+      it++)
+    if(std::find(hashes.begin(), hashes.end(), *it)!=hashes.end() &&
+       std::find(checkpoints.begin(), checkpoints.end(), *it)==
+       checkpoints.end())
+      out << "c " << *it << '\n';
+
+  if(cache_file.commit())
+    return;
+
+  // the checkpoints of the last time that are not for a prefix
+  // of the objects any more
+  for(hashest::const_iterator
+      it=previous_checkpoints.begin();
+      it!=previous_checkpoints.end();
+      it++)
+    if(std::find(hashes.begin(), hashes.end(), *it)==hashes.end())
+      remove(checkpoint_file(*it).c_str());
+}
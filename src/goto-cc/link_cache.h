@@ -0,0 +1,80 @@
+/*******************************************************************\
+
+Module: Reusing the Linking of Unchanged Object Files
+
+\*******************************************************************/
+
+#ifndef GOTO_CC_LINK_CACHE_H
+#define GOTO_CC_LINK_CACHE_H
+
+#include <vector>
+
+#include <util/message.h>
+
+class symbol_tablet;
+class goto_functionst;
+
+// Object files are linked one after the other, and how a symbol is
+// renamed depends on what has been linked before, so the result of
+// linking the first k objects only depends on their contents.  If
+// the environment variable CPROVER_LINK_CACHE names a directory,
+// that result is kept there for some k, under a hash of the contents
+// of the first k objects.  A later link of the same output starts
+// from the last result whose objects are unchanged, and only links
+// the remaining objects.
+//
+// Besides the final result, the result just before the first object
+// that changed since the previous link is kept, which is where an
+// edit-compile-link cycle will start from the next time.
+
+class link_cachet:public messaget
+{
+public:
+  explicit link_cachet(message_handlert &_message_handler);
+
+  inline bool enabled() const
+  {
+    return !directory.empty();
+  }
+
+  // hashes the objects, and reads the manifest of the previous
+  // link of 'output'; true on error, in which case the cache
+  // is not used
+  bool begin(
+    const std::string &output,
+    const std::vector<std::string> &object_files);
+
+  // restores the longest prefix of objects that has been linked
+  // before and returns its length, 0 if there is none
+  std::size_t restore(
+    symbol_tablet &symbol_table,
+    goto_functionst &goto_functions);
+
+  // to be called before linking object 'index', and after the last
+  // one with the number of objects
+  void checkpoint(
+    std::size_t index,
+    const symbol_tablet &symbol_table,
+    const goto_functionst &goto_functions);
+
+  // writes the manifest and removes what is no longer needed
+  void end();
+
+protected:
+  std::string directory;
+  std::string manifest_file;
+
+  // hashes[k] is the hash of the first k objects
+  typedef std::vector<std::string> hashest;
+  hashest hashes;
+
+  // from the previous link of the same output
+  hashest previous_hashes, previous_checkpoints;
+
+  std::size_t restored;
+  hashest checkpoints;
+
+  std::string checkpoint_file(const std::string &hash) const;
+};
+
+#endif
@@ -130,6 +130,11 @@ int goto_instrument_parse_optionst::doit()
   
   eval_verbosity();
 
+  #ifndef HAVE_THREADS
+  if(cmdline.isset("threads"))
+    warning() << "built without THREADS, --threads is ignored" << eom;
+  #endif
+
   try
   {
     register_languages();
@@ -228,6 +233,9 @@ int goto_instrument_parse_optionst::doit()
       goto_functions.update();
 
       custom_bitvector_analysist custom_bitvector_analysis;
+      if(cmdline.isset("threads"))
+        custom_bitvector_analysis.set_number_of_threads(
+          unsafe_string2unsigned(cmdline.get_value("threads")));
       custom_bitvector_analysis(goto_functions, ns);
       custom_bitvector_analysis.output(ns, goto_functions, std::cout);
 
@@ -250,6 +258,9 @@ int goto_instrument_parse_optionst::doit()
       goto_functions.update();
 
       custom_bitvector_analysist custom_bitvector_analysis;
+      if(cmdline.isset("threads"))
+        custom_bitvector_analysis.set_number_of_threads(
+          unsafe_string2unsigned(cmdline.get_value("threads")));
       custom_bitvector_analysis(goto_functions, ns);
       custom_bitvector_analysis.check(ns, goto_functions, std::cout);
 
@@ -290,10 +301,13 @@ int goto_instrument_parse_optionst::doit()
       goto_functions.update();
 
       status() << "Interval Analysis" << eom;
-      static_analysist<interval_domaint> interval_analysis(ns);
-      interval_analysis(goto_functions);
+      ait<interval_domaint> interval_analysis;
+      interval_analysis.set_narrowing_rounds(1);
+      interval_analysis(goto_functions, ns);
       
-      interval_analysis.output(goto_functions, std::cout);
+      interval_analysis.output(ns, goto_functions, std::cout);
+      interval_analysis.output_statistics(statistics());
+      statistics() << eom;
       return 0;
     }
     
@@ -755,6 +769,10 @@ void goto_instrument_parse_optionst::instrument_goto_program(
   if(cmdline.isset("error-label"))
     options.set_option("error-label", cmdline.get_value("error-label"));
 
+  // per-function checks may run in parallel
+  if(cmdline.isset("threads"))
+    options.set_option("threads", cmdline.get_value("threads"));
+
   // unwind loops 
   if(cmdline.isset("unwind"))
   {
@@ -1177,5 +1195,6 @@ void goto_instrument_parse_optionst::help()
     " --use-system-headers         with --dump-c/--dump-cpp: generate C source with includes\n"
     " --version                    show version and exit\n"
     " --xml-ui                     use XML-formatted output\n"
+    " --threads n                  run per-function checks and analyses on n threads\n"
     "\n";
 }
@@ -59,7 +59,7 @@ Author: Daniel Kroening, kroening@kroening.com
   "(interpreter)(show-reaching-definitions)(count-eloc)" \
   "(list-symbols)(list-undefined-functions)" \
   "(z3)(add-library)(show-dependence-graph)" \
-  "(horn)"
+  "(horn)(threads):"
 
 class goto_instrument_parse_optionst:
   public parse_options_baset,
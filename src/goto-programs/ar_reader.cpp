@@ -0,0 +1,205 @@
+/*******************************************************************\
+
+Module: Read Static Libraries (ar Archives)
+
+\*******************************************************************/
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+
+#include "ar_reader.h"
+
+#define AR_MAGIC "!<arch>\n"
+#define AR_THIN_MAGIC "!<thin>\n"
+#define AR_MAGIC_SIZE 8
+
+/*******************************************************************\
+
+Function: is_ar_magic
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool is_ar_magic(const char *hdr, std::size_t size)
+{
+  return size>=AR_MAGIC_SIZE &&
+         strncmp(hdr, AR_MAGIC, AR_MAGIC_SIZE)==0;
+}
+
+/*******************************************************************\
+
+Function: ar_field
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: header fields are padded with blanks
+
+\*******************************************************************/
+
+static std::string ar_field(const char *src, std::size_t size)
+{
+  std::string result(src, size);
+  std::size_t end=result.find_last_not_of(' ');
+  return end==std::string::npos?std::string():result.substr(0, end+1);
+}
+
+/*******************************************************************\
+
+Function: ar_readert::ar_readert
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+ar_readert::ar_readert(std::istream &_in):in(_in)
+{
+  char magic[AR_MAGIC_SIZE];
+  in.read(magic, AR_MAGIC_SIZE);
+
+  if(in && strncmp(magic, AR_THIN_MAGIC, AR_MAGIC_SIZE)==0)
+    throw "thin ar archives are not supported";
+
+  if(!in || !is_ar_magic(magic, AR_MAGIC_SIZE))
+    throw "ar archive malformed (magic)";
+
+  // to tell a truncated member, as seeking past the end
+  // does not fail
+  in.seekg(0, std::ios::end);
+  std::streampos file_size=in.tellg();
+  in.seekg(AR_MAGIC_SIZE);
+
+  std::string name_table;
+
+  while(true)
+  {
+    // the header: name[16] date[12] uid[6] gid[6] mode[8] size[10] fmag[2]
+    char header[60];
+    in.read(header, sizeof(header));
+
+    if(in.gcount()==0)
+      break; // done
+
+    if(in.gcount()!=sizeof(header) ||
+       header[58]!='`' || header[59]!='\n')
+      throw "ar archive malformed (member header)";
+
+    std::string name=ar_field(header, 16);
+    std::string size_string=ar_field(header+48, 10);
+
+    if(size_string.empty() ||
+       size_string.find_first_not_of("0123456789")!=std::string::npos)
+      throw "ar archive malformed (member size)";
+
+    std::size_t size=strtoul(size_string.c_str(), NULL, 10);
+    std::streampos offset=in.tellg();
+
+    if(file_size-offset<std::streamoff(size))
+      throw "ar archive truncated";
+
+    std::size_t name_size=0;
+
+    if(name=="/" || name=="/SYM64/" ||
+       name=="__.SYMDEF" || name=="__.SYMDEF SORTED")
+    {
+      // symbol index, we do our own
+    }
+    else if(name=="//")
+    {
+      // GNU table of long names
+      name_table.resize(size);
+      if(size!=0) in.read(&name_table[0], size);
+    }
+    else
+    {
+      if(name.size()>=2 && name[0]=='/' &&
+         isdigit((unsigned char)name[1]))
+      {
+        // GNU long name, an offset into the name table
+        std::size_t start=strtoul(name.c_str()+1, NULL, 10);
+
+        if(start>=name_table.size())
+          throw "ar archive malformed (long name)";
+
+        std::size_t end=name_table.find('\n', start);
+        name=name_table.substr(start, end==std::string::npos?
+                                      std::string::npos:end-start);
+      }
+      else if(name.size()>=4 && name.compare(0, 3, "#1/")==0)
+      {
+        // BSD long name, stored in front of the contents
+        name_size=strtoul(name.c_str()+3, NULL, 10);
+
+        if(name_size>size)
+          throw "ar archive malformed (long name)";
+
+        name.resize(name_size);
+        if(name_size!=0) in.read(&name[0], name_size);
+
+        // may be padded with zeros
+        name=std::string(name.c_str());
+      }
+
+      // GNU terminates names with a slash
+      if(!name.empty() && name[name.size()-1]=='/')
+        name.resize(name.size()-1);
+
+      membert member;
+      member.name=name;
+      member.offset=offset+std::streamoff(name_size);
+      member.size=size-name_size;
+      members.push_back(member);
+    }
+
+    if(!in)
+      throw "ar archive truncated";
+
+    // members are aligned to two bytes
+    in.seekg(offset+std::streamoff(size+(size%2)));
+  }
+
+  in.clear();
+}
+
+/*******************************************************************\
+
+Function: ar_readert::get_contents
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+std::string ar_readert::get_contents(
+  std::istream &in,
+  const membert &member)
+{
+  std::string result;
+  result.resize(member.size);
+
+  in.clear();
+  in.seekg(member.offset);
+
+  if(member.size!=0)
+    in.read(&result[0], member.size);
+
+  if(!in)
+    throw "ar archive truncated";
+
+  return result;
+}
@@ -0,0 +1,48 @@
+/*******************************************************************\
+
+Module: Read Static Libraries (ar Archives)
+
+\*******************************************************************/
+
+#ifndef CPROVER_AR_READER_H
+#define CPROVER_AR_READER_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// we follow the common ar format, with the GNU ("/" and "//")
+// and BSD ("#1/") ways of storing long member names
+
+class ar_readert
+{
+public:
+  explicit ar_readert(std::istream &_in);
+
+  struct membert
+  {
+    std::string name;
+    std::streampos offset; // of the contents
+    std::size_t size;
+  };
+
+  // the members, without the symbol index and the name table
+  typedef std::vector<membert> memberst;
+  memberst members;
+
+  // reads the contents of a member
+  std::string get_contents(const membert &member) const
+  {
+    return get_contents(in, member);
+  }
+
+  // the same, from a stream that has the archive
+  static std::string get_contents(std::istream &in, const membert &member);
+
+protected:
+  std::istream &in;
+};
+
+bool is_ar_magic(const char *hdr, std::size_t size);
+
+#endif
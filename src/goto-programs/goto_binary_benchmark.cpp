@@ -0,0 +1,168 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <ctime>
+
+#include <util/arith_tools.h>
+#include <util/i2string.h>
+#include <util/std_code.h>
+#include <util/std_expr.h>
+#include <util/std_types.h>
+#include <util/symbol_table.h>
+#include <util/cout_message.h>
+
+#include "read_goto_binary.h"
+#include "write_goto_binary.h"
+
+// Saves and loads a synthetic program in each version of the goto
+// binary format, and checks that it reads back unchanged.
+// Usage: goto_binary_benchmark [functions] [repetitions]
+
+static void make_program(
+  unsigned number_of_functions,
+  symbol_tablet &symbol_table,
+  goto_functionst &goto_functions)
+{
+  code_typet code_type;
+  signedbv_typet int_type(32);
+
+  struct_typet struct_type;
+  for(unsigned k=0; k<20; k++)
+    struct_type.components().push_back(
+      struct_typet::componentt("c"+i2string(k), int_type));
+
+  for(unsigned i=0; i<number_of_functions; i++)
+  {
+    const std::string name="f"+i2string(i);
+
+    symbolt function_symbol;
+    function_symbol.name=name;
+    function_symbol.base_name=name;
+    function_symbol.type=code_type;
+    function_symbol.mode=ID_C;
+    symbol_table.add(function_symbol);
+
+    symbolt local_symbol;
+    local_symbol.name=name+"::x";
+    local_symbol.base_name="x";
+    local_symbol.type=struct_type;
+    local_symbol.mode=ID_C;
+    local_symbol.is_lvalue=true;
+    symbol_table.add(local_symbol);
+
+    goto_functionst::goto_functiont &f=goto_functions.function_map[name];
+    f.type=code_type;
+    f.body_available=true;
+    goto_programt &body=f.body;
+
+    symbol_exprt x(local_symbol.name, struct_type);
+
+    for(unsigned j=0; j<40; j++)
+    {
+      exprt rhs=from_integer(j, int_type);
+
+      for(unsigned k=0; k<5; k++)
+        rhs=plus_exprt(
+          rhs, member_exprt(x, "c"+i2string((j+k)%20), int_type));
+
+      source_locationt source_location;
+      source_location.set_file("file"+i2string(i%50)+".c");
+      source_location.set_line(j+1);
+      source_location.set_function(name);
+
+      goto_programt::targett a=body.add_instruction(ASSIGN);
+      a->code=code_assignt(
+        member_exprt(x, "c"+i2string(j%20), int_type), rhs);
+      a->code.add_source_location()=source_location;
+      a->source_location=source_location;
+    }
+
+    if(i+1<number_of_functions)
+    {
+      code_function_callt call;
+      call.function()=symbol_exprt("f"+i2string(i+1), code_type);
+      body.add_instruction(FUNCTION_CALL)->code=call;
+    }
+
+    goto_programt::targett g=body.add_instruction(GOTO);
+    g->guard=true_exprt();
+    g->targets.push_back(body.add_instruction(END_FUNCTION));
+  }
+
+  goto_functions.update();
+}
+
+static double seconds()
+{
+  return double(clock())/CLOCKS_PER_SEC;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned number_of_functions=argc>1?atoi(argv[1]):2000;
+  unsigned repetitions=argc>2?atoi(argv[2]):3;
+
+  symbol_tablet symbol_table;
+  goto_functionst goto_functions;
+  make_program(number_of_functions, symbol_table, goto_functions);
+
+  std::ostringstream reference;
+  write_goto_binary(reference, symbol_table, goto_functions, 2);
+
+  cout_message_handlert message_handler;
+
+  try
+  {
+    for(int version=2; version<=4; version++)
+    {
+      std::string data;
+
+      double start=seconds();
+
+      for(unsigned r=0; r<repetitions; r++)
+      {
+        std::ostringstream out;
+        write_goto_binary(out, symbol_table, goto_functions, version);
+        data=out.str();
+      }
+
+      double saved=seconds();
+
+      symbol_tablet loaded_symbol_table;
+      goto_functionst loaded_goto_functions;
+
+      for(unsigned r=0; r<repetitions; r++)
+      {
+        loaded_symbol_table.clear();
+        loaded_goto_functions.clear();
+
+        std::istringstream in(data);
+        if(read_goto_binary(
+             in, "benchmark", loaded_symbol_table, loaded_goto_functions,
+             message_handler))
+          return 1;
+      }
+
+      double loaded=seconds();
+
+      std::ostringstream again;
+      write_goto_binary(
+        again, loaded_symbol_table, loaded_goto_functions, 2);
+
+      std::cout << "version " << version
+                << "  size " << data.size()
+                << "  save " << (saved-start)/repetitions << " s"
+                << "  load " << (loaded-saved)/repetitions << " s"
+                << (again.str()==reference.str()?"":"  MISMATCH")
+                << std::endl;
+    }
+  }
+
+  catch(const char *s)
+  {
+    std::cerr << "Exception: " << s << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
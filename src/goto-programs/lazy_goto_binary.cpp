@@ -0,0 +1,185 @@
+/*******************************************************************\
+
+Module: Reading Function Bodies of Goto Binaries on Demand
+
+\*******************************************************************/
+
+#include <stack>
+
+#include <util/find_symbols.h>
+#include <util/unicode.h>
+
+#include "goto_functions.h"
+#include "read_goto_binary.h"
+#include "elf_reader.h"
+#include "lazy_goto_binary.h"
+
+/*******************************************************************\
+
+Function: lazy_goto_binaryt::read
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool lazy_goto_binaryt::read(
+  const std::string &_filename,
+  symbol_tablet &symbol_table,
+  goto_functionst &goto_functions)
+{
+  filename=_filename;
+  index.offsets.clear();
+
+  #ifdef _MSC_VER
+  in.open(widen(filename).c_str(), std::ios::binary);
+  #else
+  in.open(filename.c_str(), std::ios::binary);
+  #endif
+
+  if(!in)
+  {
+    error() << "Failed to open `" << filename << "'" << eom;
+    return true;
+  }
+
+  char hdr[4];
+  hdr[0]=in.get();
+  hdr[1]=in.get();
+  hdr[2]=in.get();    
+  hdr[3]=in.get();
+  in.seekg(0);
+
+  if(hdr[0]==0x7f && hdr[1]=='G' && hdr[2]=='B' && hdr[3]=='F')
+  {
+    return read_bin_goto_object(
+      in, filename, symbol_table, goto_functions,
+      get_message_handler(), &index);
+  }
+  else if(hdr[0]==0x7f && hdr[1]=='E' && hdr[2]=='L' && hdr[3]=='F')
+  {
+    try
+    {
+      elf_readert elf_reader(in);
+      
+      for(unsigned i=0; i<elf_reader.number_of_sections; i++)
+        if(elf_reader.section_name(i)=="goto-cc")
+        {
+          in.seekg(elf_reader.section_offset(i));
+          return read_bin_goto_object(
+            in, filename, symbol_table, goto_functions,
+            get_message_handler(), &index);
+        }
+    }
+    
+    catch(const char *s)
+    {
+      error() << s << eom;
+      return true;
+    }
+  }
+
+  // everything else is read completely
+  in.close();
+
+  return read_goto_binary(
+    filename, symbol_table, goto_functions, get_message_handler());
+}
+
+/*******************************************************************\
+
+Function: lazy_goto_binaryt::load
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool lazy_goto_binaryt::load(
+  const irep_idt &identifier,
+  goto_functionst &goto_functions)
+{
+  goto_binary_indext::offsetst::iterator it=
+    index.offsets.find(identifier);
+
+  if(it==index.offsets.end())
+    return false;
+
+  std::streamoff offset=it->second;
+  index.offsets.erase(it);
+
+  if(read_bin_goto_function(
+       in, index.version, offset, identifier, goto_functions))
+  {
+    error() << "failed to read the body of `" << identifier
+            << "' from `" << filename << "'" << eom;
+    return true;
+  }
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: lazy_goto_binaryt::load_reachable
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: the functions that can be called from a function are
+          among the symbols it mentions, which covers calls
+          through function pointers as well
+
+\*******************************************************************/
+
+bool lazy_goto_binaryt::load_reachable(
+  const irep_idt &identifier,
+  goto_functionst &goto_functions)
+{
+  std::size_t total=index.offsets.size();
+
+  std::stack<irep_idt> worklist;
+  worklist.push(identifier);
+
+  while(!worklist.empty())
+  {
+    irep_idt id=worklist.top();
+    worklist.pop();
+
+    if(is_loaded(id))
+      continue;
+
+    if(load(id, goto_functions))
+      return true;
+
+    find_symbols_sett symbols;
+
+    const goto_programt &body=goto_functions.function_map[id].body;
+
+    forall_goto_program_instructions(i_it, body)
+    {
+      find_symbols(i_it->code, symbols);
+      find_symbols(i_it->guard, symbols);
+    }
+
+    for(find_symbols_sett::const_iterator
+        s_it=symbols.begin();
+        s_it!=symbols.end();
+        s_it++)
+      if(!is_loaded(*s_it))
+        worklist.push(*s_it);
+  }
+
+  if(total!=0)
+    statistics() << "Read " << (total-index.offsets.size()) << " of "
+                 << total << " function bodies" << eom;
+
+  return false;
+}
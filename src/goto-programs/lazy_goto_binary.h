@@ -0,0 +1,63 @@
+/*******************************************************************\
+
+Module: Reading Function Bodies of Goto Binaries on Demand
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_PROGRAMS_LAZY_GOTO_BINARY_H
+#define CPROVER_GOTO_PROGRAMS_LAZY_GOTO_BINARY_H
+
+#include <fstream>
+
+#include <util/message.h>
+
+#include "read_bin_goto_object.h"
+
+class symbol_tablet;
+class goto_functionst;
+
+// Keeps a goto binary open after its symbol table has been read,
+// and reads the bodies of functions when they are asked for.  This
+// needs an index in the binary; for binaries without one, as well
+// as for Mach-O files, everything is read right away.
+
+class lazy_goto_binaryt:public messaget
+{
+public:
+  explicit lazy_goto_binaryt(message_handlert &_message_handler):
+    messaget(_message_handler)
+  {
+  }
+
+  // reads the symbol table and the index, true on error
+  bool read(
+    const std::string &filename,
+    symbol_tablet &symbol_table,
+    goto_functionst &goto_functions);
+
+  // reads the body of the given function, unless it has already
+  // been read or there is none; true on error
+  bool load(
+    const irep_idt &identifier,
+    goto_functionst &goto_functions);
+
+  // reads the bodies of the functions that are mentioned in
+  // the function with the given name, transitively
+  bool load_reachable(
+    const irep_idt &identifier,
+    goto_functionst &goto_functions);
+
+  inline bool is_loaded(const irep_idt &identifier) const
+  {
+    return index.offsets.find(identifier)==index.offsets.end();
+  }
+
+protected:
+  std::string filename;
+  std::ifstream in;
+
+  // the bodies not read so far
+  goto_binary_indext index;
+};
+
+#endif
@@ -6,11 +6,313 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
+#include <cstdlib>
+#include <sstream>
+#include <list>
+
+#include <util/cache_file.h>
+#include <util/config.h>
+#include <util/find_symbols.h>
+#include <util/rename_symbol.h>
+
 #include <ansi-c/cprover_library.h>
 
+#include <linking/linking_class.h>
+
 #include "link_to_library.h"
 #include "compute_called_functions.h"
 #include "goto_convert_functions.h"
+#include "read_goto_binary.h"
+#include "write_goto_binary.h"
+
+// the cache is read far more often than it is written, and
+// version 4 is the fastest to read
+#define CACHE_GOTO_BINARY_VERSION 4
+
+/*******************************************************************\
+
+Function: cprover_library_cache_file
+
+  Inputs:
+
+ Outputs: the name of the file that holds the library for the
+          current configuration, or the empty string if there
+          is no cache
+
+ Purpose: the file name is a hash of everything that goes into
+          the library: the models and the configuration
+
+\*******************************************************************/
+
+static std::string cprover_library_cache_file()
+{
+  const char *cache_dir=getenv("CPROVER_LIBRARY_CACHE");
+
+  if(cache_dir==NULL || *cache_dir==0)
+    return std::string();
+
+  const configt::ansi_ct &ansi_c=config.ansi_c;
+
+  std::ostringstream key;
+
+  key << CACHE_GOTO_BINARY_VERSION << ' '
+      << ansi_c.int_width << ' ' << ansi_c.long_int_width << ' '
+      << ansi_c.bool_width << ' ' << ansi_c.char_width << ' '
+      << ansi_c.short_int_width << ' ' << ansi_c.long_long_int_width << ' '
+      << ansi_c.pointer_width << ' ' << ansi_c.single_width << ' '
+      << ansi_c.double_width << ' ' << ansi_c.long_double_width << ' '
+      << ansi_c.wchar_t_width << ' '
+      << ansi_c.char_is_unsigned << ansi_c.wchar_t_is_unsigned
+      << ansi_c.use_fixed_for_float << ansi_c.for_has_scope
+      << ansi_c.single_precision_constant << ansi_c.cpp11
+      << ansi_c.NULL_is_zero << ansi_c.string_abstraction << ' '
+      << ansi_c.rounding_mode << ' ' << ansi_c.alignment << ' '
+      << ansi_c.memory_operand_size << ' ' << ansi_c.endianness << ' '
+      << ansi_c.os << ' ' << ansi_c.arch << ' '
+      << ansi_c.mode << ' ' << ansi_c.preprocessor << '\n';
+
+  const std::list<std::string> *lists[]=
+  {
+    &ansi_c.defines, &ansi_c.undefines, &ansi_c.preprocessor_options,
+    &ansi_c.include_paths, &ansi_c.include_files
+  };
+
+  for(unsigned i=0; i<sizeof(lists)/sizeof(*lists); i++)
+  {
+    for(std::list<std::string>::const_iterator
+        it=lists[i]->begin();
+        it!=lists[i]->end();
+        it++)
+      key << *it << '\n';
+
+    key << '\n';
+  }
+
+  std::set<irep_idt> functions;
+  get_cprover_library_functions(functions);
+  key << get_cprover_library_text(functions);
+
+  fnv_hasht hash;
+  hash.add(key.str());
+
+  return std::string(cache_dir)+"/cprover-library-"+hash.str()+".gb";
+}
+
+/*******************************************************************\
+
+Function: get_cprover_library
+
+  Inputs:
+
+ Outputs: true if the library is not available as goto program
+
+ Purpose: reads the whole library from the cache, and
+          builds and stores it if it is not there yet
+
+\*******************************************************************/
+
+static bool get_cprover_library(
+  goto_modelt &library,
+  message_handlert &message_handler)
+{
+  messaget message(message_handler);
+
+  const std::string file_name=cprover_library_cache_file();
+
+  if(file_name.empty())
+    return true;
+
+  if(is_goto_binary(file_name))
+  {
+    null_message_handlert null_message_handler;
+
+    if(!read_goto_binary(file_name, library, null_message_handler))
+    {
+      message.status() << "Using cached CPROVER library "
+                       << file_name << messaget::eom;
+      return false;
+    }
+
+    library.clear();
+  }
+
+  message.status() << "Building CPROVER library cache "
+                   << file_name << messaget::eom;
+
+  std::set<irep_idt> functions;
+  get_cprover_library_functions(functions);
+
+  try
+  {
+    if(add_library(get_cprover_library_text(functions),
+                   library.symbol_table, message_handler))
+      throw 0;
+
+    goto_convert(library.symbol_table, library.goto_functions,
+                 message_handler);
+  }
+
+  catch(...)
+  {
+    message.warning() << "failed to build the CPROVER library cache"
+                      << messaget::eom;
+    library.clear();
+    return true;
+  }
+
+  cache_file_writert cache_file(file_name);
+
+  if(write_goto_binary(
+       cache_file.out(), library.symbol_table, library.goto_functions,
+       CACHE_GOTO_BINARY_VERSION) ||
+     cache_file.commit())
+    message.warning() << "failed to write the CPROVER library cache"
+                      << messaget::eom;
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: add_from_library
+
+  Inputs: the functions that lack a body, the library
+
+ Outputs: true on error, which leaves the symbol table as it
+          was; the functions that were added
+
+ Purpose: links the goto programs of the library functions,
+          together with what they depend on, without
+          type-checking or converting them again
+
+\*******************************************************************/
+
+static bool add_from_library(
+  const std::set<irep_idt> &missing_functions,
+  const goto_modelt &library,
+  symbol_tablet &symbol_table,
+  goto_functionst &goto_functions,
+  std::set<irep_idt> &added_functions,
+  message_handlert &message_handler)
+{
+  std::set<irep_idt> library_functions;
+  std::list<irep_idt> worklist;
+
+  for(std::set<irep_idt>::const_iterator
+      it=missing_functions.begin();
+      it!=missing_functions.end();
+      it++)
+  {
+    symbol_tablet::symbolst::const_iterator s_it=
+      symbol_table.symbols.find(*it);
+
+    goto_functionst::function_mapt::const_iterator f_it=
+      library.goto_functions.function_map.find(*it);
+
+    if(s_it!=symbol_table.symbols.end() &&
+       s_it->second.value.is_nil() &&
+       f_it!=library.goto_functions.function_map.end() &&
+       f_it->second.body_available)
+    {
+      library_functions.insert(*it);
+      worklist.push_back(*it);
+    }
+  }
+
+  if(library_functions.empty())
+    return false;
+
+  // collect what the functions depend on
+  symbol_tablet new_symbol_table;
+
+  while(!worklist.empty())
+  {
+    irep_idt id=worklist.front();
+    worklist.pop_front();
+
+    if(new_symbol_table.symbols.find(id)!=new_symbol_table.symbols.end())
+      continue;
+
+    symbol_tablet::symbolst::const_iterator s_it=
+      library.symbol_table.symbols.find(id);
+
+    if(s_it==library.symbol_table.symbols.end())
+      continue;
+
+    symbolt symbol=s_it->second;
+    find_symbols_sett dependencies;
+
+    if(library_functions.find(id)!=library_functions.end())
+    {
+      const goto_programt &body=
+        library.goto_functions.function_map.find(id)->second.body;
+
+      forall_goto_program_instructions(i_it, body)
+      {
+        find_type_and_expr_symbols(i_it->code, dependencies);
+        find_type_and_expr_symbols(i_it->guard, dependencies);
+      }
+    }
+    else if(symbol.type.id()==ID_code)
+    {
+      // just the declaration, the body is added
+      // if the function turns out to be called
+      symbol.value.make_nil();
+    }
+
+    find_type_and_expr_symbols(symbol.type, dependencies);
+    find_type_and_expr_symbols(symbol.value, dependencies);
+
+    for(find_symbols_sett::const_iterator
+        d_it=dependencies.begin();
+        d_it!=dependencies.end();
+        d_it++)
+      worklist.push_back(*d_it);
+
+    new_symbol_table.add(symbol);
+  }
+
+  // linking may fail half-way, and the caller then falls back
+  // to the library sources, which need the table as it was
+  symbol_tablet linked_symbol_table=symbol_table;
+
+  linkingt linking(linked_symbol_table, new_symbol_table, message_handler);
+
+  if(linking.typecheck_main())
+    return true;
+
+  symbol_table.swap(linked_symbol_table);
+
+  const rename_symbolt &rename_symbol=linking.rename_symbol;
+
+  for(std::set<irep_idt>::const_iterator
+      it=library_functions.begin();
+      it!=library_functions.end();
+      it++)
+  {
+    const goto_functionst::goto_functiont &src=
+      library.goto_functions.function_map.find(*it)->second;
+
+    goto_functionst::goto_functiont &dest=
+      goto_functions.function_map[*it];
+
+    dest.body.copy_from(src.body);
+    dest.body_available=src.body_available;
+    dest.type=src.type;
+
+    rename_symbol(dest.type);
+
+    Forall_goto_program_instructions(i_it, dest.body)
+    {
+      rename_symbol(i_it->code);
+      rename_symbol(i_it->guard);
+    }
+
+    added_functions.insert(*it);
+  }
+
+  return false;
+}
 
 /*******************************************************************\
 
@@ -56,6 +358,10 @@ void link_to_library(
 
   std::set<irep_idt> added_functions;
 
+  // the library as goto program, if there is a cache
+  goto_modelt library;
+  bool library_loaded=false, use_library_cache=true;
+
   while(true)
   {
     std::set<irep_idt> called_functions;
@@ -89,7 +395,28 @@ void link_to_library(
     // done?
     if(missing_functions.empty()) break;
     
-    add_cprover_library(missing_functions, symbol_table, message_handler);
+    if(use_library_cache &&
+       config.ansi_c.lib!=configt::ansi_ct::LIB_NONE)
+    {
+      if(!library_loaded)
+      {
+        use_library_cache=!get_cprover_library(library, message_handler);
+        library_loaded=true;
+      }
+
+      if(use_library_cache &&
+         add_from_library(missing_functions, library, symbol_table,
+                          goto_functions, added_functions, message_handler))
+      {
+        messaget message(message_handler);
+        message.warning() << "failed to link the cached CPROVER library"
+                          << messaget::eom;
+        use_library_cache=false;
+      }
+    }
+
+    if(!use_library_cache)
+      add_cprover_library(missing_functions, symbol_table, message_handler);
 
     // convert to CFG
     for(std::set<irep_idt>::const_iterator
@@ -97,6 +424,9 @@ void link_to_library(
         it!=missing_functions.end();
         it++)
     {
+      if(added_functions.find(*it)!=added_functions.end())
+        continue; // taken from the library cache
+
       if(symbol_table.symbols.find(*it)!=symbol_table.symbols.end())
         goto_convert(*it, symbol_table, goto_functions, message_handler);
         
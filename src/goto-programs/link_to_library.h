@@ -13,6 +13,12 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "goto_model.h"
 
+// Adds the bodies of the CPROVER library functions that are called.
+// If the environment variable CPROVER_LIBRARY_CACHE names a directory,
+// the whole library is kept there as goto binary, one per
+// configuration, and the functions are linked from that binary
+// instead of being parsed and type-checked on every run.
+
 void link_to_library(
   symbol_tablet &,
   goto_functionst &,
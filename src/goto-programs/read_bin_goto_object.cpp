@@ -12,28 +12,80 @@ Date: June 2006
 #include <util/message.h>
 #include <util/symbol_table.h>
 #include <util/irep_serialization.h>
+#include <util/irep_table.h>
 
 #include "goto_functions.h"
 #include "read_bin_goto_object.h"
 
 /*******************************************************************\
  
-Function: read_goto_object_v2
+Function: set_symbol_flags
+ 
+  Inputs: a symbol, the flags as they are written
+ 
+ Outputs:
+ 
+ Purpose:
+ 
+\*******************************************************************/
+
+static void set_symbol_flags(symbolt &sym, std::size_t flags)
+{
+  sym.is_type = (flags & (1 << 15))!=0;
+  sym.is_property = (flags & (1 << 14))!=0; 
+  sym.is_macro = (flags & (1 << 13))!=0;
+  sym.is_exported = (flags & (1 << 12))!=0;
+  sym.is_input = (flags & (1 << 11))!=0;
+  sym.is_output = (flags & (1 << 10))!=0;
+  sym.is_state_var = (flags & (1 << 9))!=0;
+  sym.is_parameter = (flags & (1 << 8))!=0;
+  sym.is_auxiliary = (flags & (1 << 7))!=0;
+  //sym.binding = (flags & (1 << 6))!=0;
+  sym.is_lvalue = (flags & (1 << 5))!=0;
+  sym.is_static_lifetime = (flags & (1 << 4))!=0;
+  sym.is_thread_local = (flags & (1 << 3))!=0;
+  sym.is_file_local = (flags & (1 << 2))!=0;
+  sym.is_extern = (flags & (1 << 1))!=0;
+  sym.is_volatile = (flags & 1)!=0;
+}
+
+/*******************************************************************\
+ 
+Function: add_function_symbol
+ 
+  Inputs: symbol, functions
+ 
+ Outputs:
+ 
+ Purpose: makes sure there is an empty function for every
+          function symbol and fixes the function types
+ 
+\*******************************************************************/
+
+static void add_function_symbol(
+  const symbolt &sym,
+  goto_functionst &functions)
+{
+  if(!sym.is_type && sym.type.id()==ID_code)
+    functions.function_map[sym.name].type=to_code_type(sym.type);      
+}
+
+/*******************************************************************\
+ 
+Function: read_bin_goto_object_symbols
  
   Inputs: input stream, symbol_table, functions
  
- Outputs: true on error, false otherwise
+ Outputs:
  
- Purpose: read goto binary format v2
+ Purpose: reads the symbol table, the same in versions 2 and 3
  
 \*******************************************************************/
 
-bool read_bin_goto_object_v2(
+static void read_bin_goto_object_symbols(
   std::istream &in,
-  const std::string &filename,
   symbol_tablet &symbol_table,
   goto_functionst &functions,
-  message_handlert &message_handler,
   irep_serializationt &irepconverter)
 { 
   std::size_t count = irepconverter.read_gb_word(in); // # of symbols
@@ -55,105 +107,407 @@ bool read_bin_goto_object_v2(
     // obsolete: symordering
     irepconverter.read_gb_word(in);
 
-    std::size_t flags=irepconverter.read_gb_word(in);
+    set_symbol_flags(sym, irepconverter.read_gb_word(in));
     
-    sym.is_type = (flags & (1 << 15))!=0;
-    sym.is_property = (flags & (1 << 14))!=0; 
-    sym.is_macro = (flags & (1 << 13))!=0;
-    sym.is_exported = (flags & (1 << 12))!=0;
-    sym.is_input = (flags & (1 << 11))!=0;
-    sym.is_output = (flags & (1 << 10))!=0;
-    sym.is_state_var = (flags & (1 << 9))!=0;
-    sym.is_parameter = (flags & (1 << 8))!=0;
-    sym.is_auxiliary = (flags & (1 << 7))!=0;
-    //sym.binding = (flags & (1 << 6))!=0;
-    sym.is_lvalue = (flags & (1 << 5))!=0;
-    sym.is_static_lifetime = (flags & (1 << 4))!=0;
-    sym.is_thread_local = (flags & (1 << 3))!=0;
-    sym.is_file_local = (flags & (1 << 2))!=0;
-    sym.is_extern = (flags & (1 << 1))!=0;
-    sym.is_volatile = (flags & 1)!=0;
+    add_function_symbol(sym, functions);
+    symbol_table.add(sym);
+  }
+}
+
+typedef std::map<goto_programt::targett, std::list<unsigned> > target_mapt;
+typedef std::map<unsigned, goto_programt::targett> rev_target_mapt;
+
+/*******************************************************************\
+ 
+Function: resolve_targets
+ 
+  Inputs: the target numbers of the jumps, the instructions
+          with the target numbers
+ 
+ Outputs:
+ 
+ Purpose: turns the target numbers of jumps into targets
+ 
+\*******************************************************************/
+
+static void resolve_targets(
+  target_mapt &target_map,
+  const rev_target_mapt &rev_target_map)
+{
+  for(target_mapt::iterator tit = target_map.begin();
+      tit!=target_map.end();
+      tit++)
+  {
+    goto_programt::targett ins = tit->first;
     
-    if(!sym.is_type && sym.type.id()==ID_code)
+    for(std::list<unsigned>::iterator nit = tit->second.begin();
+        nit!=tit->second.end();
+        nit++)
     {
-      // makes sure there is an empty function
-      // for every function symbol and fixes
-      // the function types. 
-      functions.function_map[sym.name].type=to_code_type(sym.type);      
+      unsigned n=*nit;
+      rev_target_mapt::const_iterator entry=rev_target_map.find(n);
+      assert(entry!=rev_target_map.end());
+      ins->targets.push_back(entry->second);
     }
+  }
+}
+
+/*******************************************************************\
+ 
+Function: read_bin_goto_object_function
+ 
+  Inputs: input stream, the function to read the body into
+ 
+ Outputs:
+ 
+ Purpose: reads the instructions of one function body
+ 
+\*******************************************************************/
+
+static void read_bin_goto_object_function(
+  std::istream &in,
+  goto_functionst::goto_functiont &f,
+  irep_serializationt &irepconverter)
+{
+  target_mapt target_map;
+  rev_target_mapt rev_target_map;
+  
+  std::size_t ins_count = irepconverter.read_gb_word(in); // # of instructions
+  for(std::size_t i=0; i<ins_count; i++)
+  {
+    goto_programt::targett itarget = f.body.add_instruction();
+    goto_programt::instructiont &instruction=*itarget;
     
-    symbol_table.add(sym);
+    irepconverter.reference_convert(in, instruction.code);
+    instruction.function = irepconverter.read_string_ref(in);      
+    irepconverter.reference_convert(in, instruction.source_location);
+    instruction.type = (goto_program_instruction_typet) 
+                            irepconverter.read_gb_word(in);
+    instruction.guard.make_nil();
+    irepconverter.reference_convert(in, instruction.guard);
+    irepconverter.read_string_ref(in); // former event
+    instruction.target_number = irepconverter.read_gb_word(in);
+    if(instruction.is_target() &&
+        rev_target_map.insert(rev_target_map.end(),
+          std::make_pair(instruction.target_number, itarget))->second!=itarget)
+      assert(false);
+    
+    std::size_t t_count = irepconverter.read_gb_word(in); // # of targets
+    for(std::size_t i=0; i<t_count; i++)
+      // just save the target numbers
+      target_map[itarget].push_back(irepconverter.read_gb_word(in));
+      
+    std::size_t l_count = irepconverter.read_gb_word(in); // # of labels
+    for(std::size_t i=0; i<l_count; i++)
+      instruction.labels.push_back(irepconverter.read_string_ref(in));
   }
   
-  count=irepconverter.read_gb_word(in); // # of functions
+  resolve_targets(target_map, rev_target_map);
+
+  f.body.update();
+  f.body_available=f.body.instructions.size()>0;    
+}
+
+/*******************************************************************\
+ 
+Function: read_goto_object_v2
+ 
+  Inputs: input stream, symbol_table, functions
+ 
+ Outputs: true on error, false otherwise
+ 
+ Purpose: read goto binary format v2
+ 
+\*******************************************************************/
+
+bool read_bin_goto_object_v2(
+  std::istream &in,
+  const std::string &filename,
+  symbol_tablet &symbol_table,
+  goto_functionst &functions,
+  message_handlert &message_handler,
+  irep_serializationt &irepconverter)
+{ 
+  read_bin_goto_object_symbols(in, symbol_table, functions, irepconverter);
+  
+  std::size_t count=irepconverter.read_gb_word(in); // # of functions
   
   for(std::size_t i=0; i<count; i++)
   {    
     irep_idt fname=irepconverter.read_gb_string(in);
-    goto_functionst::goto_functiont &f = functions.function_map[fname];
-    
-    typedef std::map<goto_programt::targett, std::list<unsigned> > target_mapt;
-    target_mapt target_map;
-    typedef std::map<unsigned, goto_programt::targett> rev_target_mapt;
-    rev_target_mapt rev_target_map;
-    
-    std::size_t ins_count = irepconverter.read_gb_word(in); // # of instructions
-    for(std::size_t i=0; i<ins_count; i++)
+    read_bin_goto_object_function(
+      in, functions.function_map[fname], irepconverter);
+  }
+  
+  return false;
+}
+
+/*******************************************************************\
+ 
+Function: read_goto_object_v3
+ 
+  Inputs: input stream, symbol_table, functions, and optionally
+          an index to be filled instead of reading the bodies
+ 
+ Outputs: true on error, false otherwise
+ 
+ Purpose: read goto binary format v3
+ 
+\*******************************************************************/
+
+bool read_bin_goto_object_v3(
+  std::istream &in,
+  const std::string &filename,
+  symbol_tablet &symbol_table,
+  goto_functionst &functions,
+  message_handlert &message_handler,
+  irep_serializationt &irepconverter,
+  goto_binary_indext *index)
+{ 
+  read_bin_goto_object_symbols(in, symbol_table, functions, irepconverter);
+  
+  std::size_t count=irepconverter.read_gb_word(in); // # of functions
+
+  std::vector<std::pair<irep_idt, std::size_t> > entries;
+  entries.reserve(count);
+
+  for(std::size_t i=0; i<count; i++)
+  {
+    irep_idt fname=irepconverter.read_gb_string(in);
+    std::size_t size=irepconverter.read_gb_word(in); // # of bytes
+    entries.push_back(std::make_pair(fname, size));
+  }
+
+  if(!in)
+  {
+    messaget message(message_handler);
+    message.error() << "`" << filename << "' is truncated" << messaget::eom;
+    return true;
+  }
+
+  if(index!=NULL)
+  {
+    // the bodies follow the index, in the same order
+    std::streamoff offset=in.tellg();
+
+    index->version=3;
+
+    for(std::size_t i=0; i<count; i++)
     {
-      goto_programt::targett itarget = f.body.add_instruction();
-      goto_programt::instructiont &instruction=*itarget;
-      
-      irepconverter.reference_convert(in, instruction.code);
-      instruction.function = irepconverter.read_string_ref(in);      
-      irepconverter.reference_convert(in, instruction.source_location);
-      instruction.type = (goto_program_instruction_typet) 
-                              irepconverter.read_gb_word(in);
-      instruction.guard.make_nil();
-      irepconverter.reference_convert(in, instruction.guard);
-      irepconverter.read_string_ref(in); // former event
-      instruction.target_number = irepconverter.read_gb_word(in);
-      if(instruction.is_target() &&
-          rev_target_map.insert(rev_target_map.end(),
-            std::make_pair(instruction.target_number, itarget))->second!=itarget)
-        assert(false);
-      
-      std::size_t t_count = irepconverter.read_gb_word(in); // # of targets
-      for(std::size_t i=0; i<t_count; i++)
-        // just save the target numbers
-        target_map[itarget].push_back(irepconverter.read_gb_word(in));
-        
-      std::size_t l_count = irepconverter.read_gb_word(in); // # of labels
-      for(std::size_t i=0; i<l_count; i++)
-        instruction.labels.push_back(irepconverter.read_string_ref(in));
+      index->offsets[entries[i].first]=offset;
+      offset+=entries[i].second;
     }
-    
-    // Resolve targets
-    for(target_mapt::iterator tit = target_map.begin();
-        tit!=target_map.end();
-        tit++)
+
+    return false;
+  }
+  
+  for(std::size_t i=0; i<count; i++)
+  {    
+    irep_serializationt::ireps_containert body_ic;
+    irep_serializationt body_irepconverter(body_ic);
+    read_bin_goto_object_function(
+      in, functions.function_map[entries[i].first], body_irepconverter);
+  }
+  
+  return false;
+}
+
+/*******************************************************************\
+ 
+Function: read_bin_goto_object_function_v4
+ 
+  Inputs: a block, the function to read the body into
+ 
+ Outputs:
+ 
+ Purpose: reads the instructions of one function body
+ 
+\*******************************************************************/
+
+static void read_bin_goto_object_function_v4(
+  irep_table_readert &block,
+  goto_functionst::goto_functiont &f)
+{
+  target_mapt target_map;
+  rev_target_mapt rev_target_map;
+
+  std::size_t ins_count=block.word(); // # of instructions
+  for(std::size_t i=0; i<ins_count; i++)
+  {
+    goto_programt::targett itarget=f.body.add_instruction();
+    goto_programt::instructiont &instruction=*itarget;
+
+    instruction.code=static_cast<const codet &>(block.irep());
+    instruction.function=block.string();
+    instruction.source_location=
+      static_cast<const source_locationt &>(block.irep());
+    instruction.type=(goto_program_instruction_typet)block.word();
+    instruction.guard=static_cast<const exprt &>(block.irep());
+    instruction.target_number=block.word();
+    if(instruction.is_target() &&
+        rev_target_map.insert(rev_target_map.end(),
+          std::make_pair(instruction.target_number, itarget))->second!=itarget)
+      assert(false);
+
+    std::size_t t_count=block.word(); // # of targets
+    for(std::size_t i=0; i<t_count; i++)
+      target_map[itarget].push_back(block.word());
+
+    std::size_t l_count=block.word(); // # of labels
+    for(std::size_t i=0; i<l_count; i++)
+      instruction.labels.push_back(block.string());
+  }
+
+  resolve_targets(target_map, rev_target_map);
+
+  f.body.update();
+  f.body_available=f.body.instructions.size()>0;
+}
+
+/*******************************************************************\
+ 
+Function: read_goto_object_v4
+ 
+  Inputs: input stream, symbol_table, functions, and optionally
+          an index to be filled instead of reading the bodies
+ 
+ Outputs: true on error, false otherwise
+ 
+ Purpose: read goto binary format v4
+ 
+\*******************************************************************/
+
+bool read_bin_goto_object_v4(
+  std::istream &in,
+  const std::string &filename,
+  symbol_tablet &symbol_table,
+  goto_functionst &functions,
+  message_handlert &message_handler,
+  goto_binary_indext *index)
+{
+  irep_table_readert block;
+
+  block.read(in);
+
+  std::size_t count=block.word(); // # of symbols
+
+  for(std::size_t i=0; i<count; i++)
+  {
+    symbolt sym;
+
+    sym.type=static_cast<const typet &>(block.irep());
+    sym.value=static_cast<const exprt &>(block.irep());
+    sym.location=static_cast<const source_locationt &>(block.irep());
+
+    sym.name=block.string();
+    sym.module=block.string();
+    sym.base_name=block.string();
+    sym.mode=block.string();
+    sym.pretty_name=block.string();
+
+    set_symbol_flags(sym, block.word());
+
+    add_function_symbol(sym, functions);
+    symbol_table.add(sym);
+  }
+
+  // the index
+  block.read(in);
+
+  count=block.word(); // # of functions
+
+  std::vector<std::pair<irep_idt, std::size_t> > entries;
+  entries.reserve(count);
+
+  for(std::size_t i=0; i<count; i++)
+  {
+    irep_idt fname=block.string();
+    std::size_t size=block.word(); // # of bytes
+    entries.push_back(std::make_pair(fname, size));
+  }
+
+  if(index!=NULL)
+  {
+    // the bodies follow the index, in the same order
+    std::streamoff offset=in.tellg();
+
+    index->version=4;
+
+    for(std::size_t i=0; i<count; i++)
     {
-      goto_programt::targett ins = tit->first;
-      
-      for(std::list<unsigned>::iterator nit = tit->second.begin();
-          nit!=tit->second.end();
-          nit++)
-      {
-        unsigned n=*nit;
-        rev_target_mapt::const_iterator entry=rev_target_map.find(n);
-        assert(entry!=rev_target_map.end());
-        ins->targets.push_back(entry->second);
-      }
+      index->offsets[entries[i].first]=offset;
+      offset+=entries[i].second;
     }
-    
-    f.body.update();
-    f.body_available=f.body.instructions.size()>0;    
+
+    return false;
   }
-  
+
+  for(std::size_t i=0; i<count; i++)
+  {
+    block.read(in);
+    read_bin_goto_object_function_v4(
+      block, functions.function_map[entries[i].first]);
+  }
+
   return false;
 }
 
 /*******************************************************************\
  
+Function: read_bin_goto_function
+ 
+  Inputs: input stream, the version and an offset from an index
+          of the binary, the name of the function
+ 
+ Outputs: true on error, false otherwise
+ 
+ Purpose: reads the body of one function of a goto binary
+          with an index
+ 
+\*******************************************************************/
+
+bool read_bin_goto_function(
+  std::istream &in,
+  std::size_t version,
+  std::streamoff offset,
+  const irep_idt &identifier,
+  goto_functionst &functions)
+{
+  in.clear();
+  in.seekg(offset);
+
+  if(!in)
+    return true;
+
+  goto_functionst::goto_functiont &f=functions.function_map[identifier];
+  f.body.clear();
+
+  if(version==4)
+  {
+    try
+    {
+      irep_table_readert block;
+      block.read(in);
+      read_bin_goto_object_function_v4(block, f);
+    }
+
+    catch(const char *)
+    {
+      return true;
+    }
+
+    return false;
+  }
+
+  irep_serializationt::ireps_containert ic;
+  irep_serializationt irepconverter(ic);
+  read_bin_goto_object_function(in, f, irepconverter);
+
+  return !in;
+}
+
+/*******************************************************************\
+ 
 Function: read_goto_object
  
   Inputs: input stream, symbol table, functions
@@ -170,6 +524,33 @@ bool read_bin_goto_object(
   symbol_tablet &symbol_table,
   goto_functionst &functions,
   message_handlert &message_handler)
+{
+  return read_bin_goto_object(
+    in, filename, symbol_table, functions, message_handler, NULL);
+}
+
+/*******************************************************************\
+ 
+Function: read_goto_object
+ 
+  Inputs: input stream, symbol table, functions, and an index
+          that may be NULL
+ 
+ Outputs: true on error, false otherwise
+ 
+ Purpose: as above, but if there is an index, the function
+          bodies of a binary that has one are not read, and
+          the index says where they are
+ 
+\*******************************************************************/
+
+bool read_bin_goto_object(
+  std::istream &in,
+  const std::string &filename,
+  symbol_tablet &symbol_table,
+  goto_functionst &functions,
+  message_handlert &message_handler,
+  goto_binary_indext *index)
 { 
   messaget message(message_handler);
 
@@ -228,6 +609,30 @@ bool read_bin_goto_object(
                                      irepconverter);
       break;
 
+    case 3:
+      return read_bin_goto_object_v3(in, filename, 
+                                     symbol_table, functions, 
+                                     message_handler,
+                                     irepconverter,
+                                     index);
+      break;
+
+    case 4:
+      try
+      {
+        return read_bin_goto_object_v4(in, filename, 
+                                       symbol_table, functions, 
+                                       message_handler,
+                                       index);
+      }
+
+      catch(const char *s)
+      {
+        message.error() << "`" << filename << "': " << s << messaget::eom;
+        return true;
+      }
+      break;
+
     default:
       message.error() <<
           "The input was compiled with an unsupported version of "
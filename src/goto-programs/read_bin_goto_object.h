@@ -11,9 +11,12 @@ Date: May 2007
 #ifndef CPROVER_READ_BIN_GOTO_OBJECT_H
 #define CPROVER_READ_BIN_GOTO_OBJECT_H
 
-#include <iosfwd>
+#include <ios>
+#include <map>
 #include <string>
 
+#include <util/irep.h>
+
 class symbol_tablet;
 class goto_functionst;
 class message_handlert;
@@ -25,4 +28,36 @@ bool read_bin_goto_object(
   goto_functionst &goto_functions,
   message_handlert &message_handler);
 
+// Where the function bodies are, for binaries that have an
+// index (version 3 and later).
+class goto_binary_indext
+{
+public:
+  std::size_t version;
+
+  typedef std::map<irep_idt, std::streamoff> offsetst;
+  offsetst offsets;
+
+  goto_binary_indext():version(0)
+  {
+  }
+};
+
+// Reads the symbols only, and fills the index, if the binary has
+// one; binaries of earlier versions are read completely.
+bool read_bin_goto_object(
+  std::istream &in,
+  const std::string &filename,
+  symbol_tablet &symbol_table,
+  goto_functionst &goto_functions,
+  message_handlert &message_handler,
+  goto_binary_indext *index);
+
+bool read_bin_goto_function(
+  std::istream &in,
+  std::size_t version,
+  std::streamoff offset,
+  const irep_idt &identifier,
+  goto_functionst &goto_functions);
+
 #endif /*READ_BIN_GOTO_OBJECT_H_*/
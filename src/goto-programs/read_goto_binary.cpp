@@ -87,38 +87,7 @@ bool read_goto_binary(
   hdr[3]=in.get();
   in.seekg(0);
 
-  if(hdr[0]==0x7f && hdr[1]=='G' && hdr[2]=='B' && hdr[3]=='F')
-  {
-    return read_bin_goto_object(
-      in, filename, symbol_table, goto_functions, message_handler);
-  }
-  else if(hdr[0]==0x7f && hdr[1]=='E' && hdr[2]=='L' && hdr[3]=='F')
-  {
-    // ELF binary.
-    // This _may_ have a goto-cc section.
-    try
-    {
-      elf_readert elf_reader(in);
-      
-      for(unsigned i=0; i<elf_reader.number_of_sections; i++)
-        if(elf_reader.section_name(i)=="goto-cc")
-        {
-          in.seekg(elf_reader.section_offset(i));
-          return read_bin_goto_object(
-            in, filename, symbol_table, goto_functions, message_handler);
-        }
-        
-      // section not found
-      messaget(message_handler).error() <<
-        "failed to find goto-cc section in ELF binary" << messaget::eom;
-    }
-    
-    catch(const char *s)
-    {
-      messaget(message_handler).error() << s << messaget::eom;
-    }
-  }
-  else if(is_osx_fat_magic(hdr))
+  if(is_osx_fat_magic(hdr))
   {
     std::string tempname;
     // Mach-O universal binary
@@ -155,6 +124,71 @@ bool read_goto_binary(
       messaget(message_handler).error() << s << messaget::eom;
     }
   }
+  else
+    return read_goto_binary(
+      in, filename, symbol_table, goto_functions, message_handler);
+  
+  return true;
+}
+
+/*******************************************************************\
+
+Function: read_goto_binary
+
+  Inputs: a stream that holds nothing but the binary
+
+ Outputs: true on error
+
+ Purpose: reads goto binaries and ELF files with goto-cc section,
+          e.g., from the members of an archive
+
+\*******************************************************************/
+
+bool read_goto_binary(
+  std::istream &in,
+  const std::string &filename,
+  symbol_tablet &symbol_table,
+  goto_functionst &goto_functions,
+  message_handlert &message_handler)
+{
+  char hdr[4];
+  hdr[0]=in.get();
+  hdr[1]=in.get();
+  hdr[2]=in.get();    
+  hdr[3]=in.get();
+  in.seekg(0);
+
+  if(hdr[0]==0x7f && hdr[1]=='G' && hdr[2]=='B' && hdr[3]=='F')
+  {
+    return read_bin_goto_object(
+      in, filename, symbol_table, goto_functions, message_handler);
+  }
+  else if(hdr[0]==0x7f && hdr[1]=='E' && hdr[2]=='L' && hdr[3]=='F')
+  {
+    // ELF binary.
+    // This _may_ have a goto-cc section.
+    try
+    {
+      elf_readert elf_reader(in);
+      
+      for(unsigned i=0; i<elf_reader.number_of_sections; i++)
+        if(elf_reader.section_name(i)=="goto-cc")
+        {
+          in.seekg(elf_reader.section_offset(i));
+          return read_bin_goto_object(
+            in, filename, symbol_table, goto_functions, message_handler);
+        }
+        
+      // section not found
+      messaget(message_handler).error() <<
+        "failed to find goto-cc section in ELF binary" << messaget::eom;
+    }
+    
+    catch(const char *s)
+    {
+      messaget(message_handler).error() << s << messaget::eom;
+    }
+  }
   else
   {
     messaget(message_handler).error() <<
@@ -186,9 +220,8 @@ bool is_goto_binary(const std::string &filename)
   
   if(!in) return false;
   
-  // We accept two forms:
-  // 1. goto binaries, marked with 0x7f GBF
-  // 2. ELF binaries, marked with 0x7f ELF
+  // In addition to what is_goto_binary accepts for streams,
+  // we accept Mach-O universal binaries.
 
   char hdr[4];
   hdr[0]=in.get();
@@ -196,33 +229,66 @@ bool is_goto_binary(const std::string &filename)
   hdr[2]=in.get();    
   hdr[3]=in.get();
 
-  if(hdr[0]==0x7f && hdr[1]=='G' && hdr[2]=='B' && hdr[3]=='F')
+  if(is_osx_fat_magic(hdr))
   {
-    return true; // yes, this is a goto binary
-  }
-  else if(hdr[0]==0x7f && hdr[1]=='E' && hdr[2]=='L' && hdr[3]=='F')
-  {
-    // this _may_ have a goto-cc section
+    // this _may_ have a goto binary as hppa7100LC architecture
     try
     {
       in.seekg(0);
-      elf_readert elf_reader(in);
-      if(elf_reader.has_section("goto-cc")) return true;
+      osx_fat_readert osx_fat_reader(in);
+      if(osx_fat_reader.has_gb()) return true;
     }
     
     catch(...)
     {
       // ignore any errors
     }
+
+    return false;
+  }
+
+  in.seekg(0);
+  return is_goto_binary(in);
+}
+
+/*******************************************************************\
+
+Function: is_goto_binary
+
+  Inputs: a stream that holds nothing but the binary
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool is_goto_binary(std::istream &in)
+{
+  // We accept two forms:
+  // 1. goto binaries, marked with 0x7f GBF
+  // 2. ELF binaries, marked with 0x7f ELF
+
+  char hdr[4];
+  hdr[0]=in.get();
+  hdr[1]=in.get();
+  hdr[2]=in.get();    
+  hdr[3]=in.get();
+
+  if(!in) return false;
+
+  if(hdr[0]==0x7f && hdr[1]=='G' && hdr[2]=='B' && hdr[3]=='F')
+  {
+    return true; // yes, this is a goto binary
   }
-  else if(is_osx_fat_magic(hdr))
+  else if(hdr[0]==0x7f && hdr[1]=='E' && hdr[2]=='L' && hdr[3]=='F')
   {
-    // this _may_ have a goto binary as hppa7100LC architecture
+    // this _may_ have a goto-cc section
     try
     {
       in.seekg(0);
-      osx_fat_readert osx_fat_reader(in);
-      if(osx_fat_reader.has_gb()) return true;
+      elf_readert elf_reader(in);
+      if(elf_reader.has_section("goto-cc")) return true;
     }
     
     catch(...)
@@ -9,6 +9,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_GOTO_PROGRAMS_READ_GOTO_BINARY_H
 #define CPROVER_GOTO_PROGRAMS_READ_GOTO_BINARY_H
 
+#include <iosfwd>
 #include <string>
 
 class symbol_tablet;
@@ -29,4 +30,15 @@ bool read_goto_binary(
   
 bool is_goto_binary(const std::string &filename);
 
+// for binaries that are not files of their own,
+// e.g., members of archives
+bool read_goto_binary(
+  std::istream &in,
+  const std::string &filename,
+  symbol_tablet &symbol_table,
+  goto_functionst &dest,
+  message_handlert &message_handler);
+
+bool is_goto_binary(std::istream &in);
+
 #endif
@@ -7,33 +7,68 @@ Author: CM Wintersteiger
 \*******************************************************************/
 
 #include <fstream>
+#include <sstream>
+#include <list>
 
 #include <util/message.h>
 #include <util/irep_serialization.h>
+#include <util/irep_table.h>
 #include <util/symbol_table.h>
 
 #include "write_goto_binary.h"
 
 /*******************************************************************\
 
-Function: goto_programt::write_goto_binary_v2
+Function: symbol_flags
 
   Inputs:
 
  Outputs:
 
- Purpose: Writes a goto program to disc, using goto binary format ver 2
+ Purpose: the flags of a symbol, as they are written
 
 \*******************************************************************/
 
-bool write_goto_binary_v2(
+static unsigned symbol_flags(const symbolt &sym)
+{
+  unsigned flags=0;    
+  flags = (flags << 1) | (int)sym.is_type; 
+  flags = (flags << 1) | (int)sym.is_property;
+  flags = (flags << 1) | (int)sym.is_macro;
+  flags = (flags << 1) | (int)sym.is_exported;
+  flags = (flags << 1) | (int)sym.is_input;
+  flags = (flags << 1) | (int)sym.is_output;
+  flags = (flags << 1) | (int)sym.is_state_var;
+  flags = (flags << 1) | (int)sym.is_parameter;
+  flags = (flags << 1) | (int)sym.is_auxiliary;
+  flags = (flags << 1) | (int)false; // sym.binding;
+  flags = (flags << 1) | (int)sym.is_lvalue;
+  flags = (flags << 1) | (int)sym.is_static_lifetime;
+  flags = (flags << 1) | (int)sym.is_thread_local;
+  flags = (flags << 1) | (int)sym.is_file_local;
+  flags = (flags << 1) | (int)sym.is_extern;
+  flags = (flags << 1) | (int)sym.is_volatile;
+
+  return flags;
+}
+
+/*******************************************************************\
+
+Function: write_goto_binary_symbols
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Writes the symbol table, the same in versions 2 and 3
+
+\*******************************************************************/
+
+static void write_goto_binary_symbols(
   std::ostream &out,
   const symbol_tablet &lsymbol_table,
-  const goto_functionst &functions,
   irep_serializationt &irepconverter)
 {
-  // first write symbol table
-
   write_gb_word(out, lsymbol_table.symbols.size());
 
   forall_symbols(it, lsymbol_table.symbols)
@@ -55,26 +90,80 @@ bool write_goto_binary_v2(
     
     write_gb_word(out, 0); // old: sym.ordering
 
-    unsigned flags=0;    
-    flags = (flags << 1) | (int)sym.is_type; 
-    flags = (flags << 1) | (int)sym.is_property;
-    flags = (flags << 1) | (int)sym.is_macro;
-    flags = (flags << 1) | (int)sym.is_exported;
-    flags = (flags << 1) | (int)sym.is_input;
-    flags = (flags << 1) | (int)sym.is_output;
-    flags = (flags << 1) | (int)sym.is_state_var;
-    flags = (flags << 1) | (int)sym.is_parameter;
-    flags = (flags << 1) | (int)sym.is_auxiliary;
-    flags = (flags << 1) | (int)false; // sym.binding;
-    flags = (flags << 1) | (int)sym.is_lvalue;
-    flags = (flags << 1) | (int)sym.is_static_lifetime;
-    flags = (flags << 1) | (int)sym.is_thread_local;
-    flags = (flags << 1) | (int)sym.is_file_local;
-    flags = (flags << 1) | (int)sym.is_extern;
-    flags = (flags << 1) | (int)sym.is_volatile;
+    write_gb_word(out, symbol_flags(sym));
+  }
+}
+
+/*******************************************************************\
+
+Function: write_goto_binary_function
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Writes the instructions of one function body
+
+\*******************************************************************/
+
+static void write_goto_binary_function(
+  std::ostream &out,
+  const goto_functionst::goto_functiont &function,
+  irep_serializationt &irepconverter)
+{
+  // In version 2, goto functions are not converted to ireps,
+  // instead they are saved in a custom binary format      
+
+  write_gb_word(out, function.body.instructions.size()); // # instructions
+  
+  forall_goto_program_instructions(i_it, function.body)
+  {
+    const goto_programt::instructiont &instruction = *i_it;
     
-    write_gb_word(out, flags);
+    irepconverter.reference_convert(instruction.code, out);
+    irepconverter.write_string_ref(out, instruction.function);
+    irepconverter.reference_convert(instruction.source_location, out);
+    write_gb_word(out, (long)instruction.type);
+    irepconverter.reference_convert(instruction.guard, out);        
+    irepconverter.write_string_ref(out, irep_idt()); // former event
+    write_gb_word(out, instruction.target_number);
+            
+    write_gb_word(out, instruction.targets.size());
+    for(goto_programt::targetst::const_iterator
+        t_it=instruction.targets.begin();
+        t_it!=instruction.targets.end();
+        t_it++)
+      write_gb_word(out, (*t_it)->target_number);
+      
+    write_gb_word(out, instruction.labels.size());
+    for(goto_programt::instructiont::labelst::const_iterator
+        l_it=instruction.labels.begin();
+        l_it!=instruction.labels.end();
+        l_it++)
+      irepconverter.write_string_ref(out, *l_it);
   }
+}
+
+/*******************************************************************\
+
+Function: goto_programt::write_goto_binary_v2
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Writes a goto program to disc, using goto binary format ver 2
+
+\*******************************************************************/
+
+bool write_goto_binary_v2(
+  std::ostream &out,
+  const symbol_tablet &lsymbol_table,
+  const goto_functionst &functions,
+  irep_serializationt &irepconverter)
+{
+  // first write symbol table
+  write_goto_binary_symbols(out, lsymbol_table, irepconverter);
 
   // now write functions, but only those with body
 
@@ -92,45 +181,189 @@ bool write_goto_binary_v2(
   {
     if(it->second.body_available)
     {      
-      // In version 2, goto functions are not converted to ireps,
-      // instead they are saved in a custom binary format      
-      
       write_gb_string(out, id2string(it->first)); // name      
-      write_gb_word(out, it->second.body.instructions.size()); // # instructions
-      
+      write_goto_binary_function(out, it->second, irepconverter);
+    }
+  }
+
+  //irepconverter.output_map(f);
+  //irepconverter.output_string_map(f);  
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: goto_programt::write_goto_binary_v3
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Writes a goto program to disc, using goto binary format
+          ver 3: as version 2, but the functions are preceded by
+          an index with the size of each body, and each body
+          has its own irep numbering, so that a reader can get
+          any one of them without reading the others
+
+\*******************************************************************/
+
+bool write_goto_binary_v3(
+  std::ostream &out,
+  const symbol_tablet &lsymbol_table,
+  const goto_functionst &functions,
+  irep_serializationt &irepconverter)
+{
+  write_goto_binary_symbols(out, lsymbol_table, irepconverter);
+
+  typedef std::list<std::pair<irep_idt, std::string> > bodiest;
+  bodiest bodies;
+
+  forall_goto_functions(it, functions)  
+    if(it->second.body_available)
+    {
+      std::ostringstream body;
+      irep_serializationt::ireps_containert body_irepc;
+      irep_serializationt body_irepconverter(body_irepc);
+      write_goto_binary_function(body, it->second, body_irepconverter);
+
+      bodies.push_back(std::make_pair(it->first, std::string()));
+      bodies.back().second=body.str();
+    }
+
+  // the index
+  write_gb_word(out, bodies.size());
+
+  for(bodiest::const_iterator
+      it=bodies.begin();
+      it!=bodies.end();
+      it++)
+  {
+    write_gb_string(out, id2string(it->first)); // name
+    write_gb_word(out, it->second.size()); // # bytes
+  }
+
+  // the bodies, in the order of the index
+  for(bodiest::const_iterator
+      it=bodies.begin();
+      it!=bodies.end();
+      it++)
+    out.write(it->second.data(), it->second.size());
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: goto_programt::write_goto_binary_v4
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Writes a goto program to disc, using goto binary format
+          ver 4: the same parts as version 3, each written as a
+          block with tables of ireps and strings, see irep_table.h
+
+\*******************************************************************/
+
+bool write_goto_binary_v4(
+  std::ostream &out,
+  const symbol_tablet &lsymbol_table,
+  const goto_functionst &functions)
+{
+  {
+    irep_table_writert symbols;
+
+    symbols.word(lsymbol_table.symbols.size());
+
+    forall_symbols(it, lsymbol_table.symbols)
+    {
+      const symbolt &sym=it->second;
+
+      symbols.irep(sym.type);
+      symbols.irep(sym.value);
+      symbols.irep(sym.location);
+
+      symbols.string(sym.name);
+      symbols.string(sym.module);
+      symbols.string(sym.base_name);
+      symbols.string(sym.mode);
+      symbols.string(sym.pretty_name);
+
+      symbols.word(symbol_flags(sym));
+    }
+
+    symbols.write(out);
+  }
+
+  typedef std::list<std::pair<irep_idt, std::string> > bodiest;
+  bodiest bodies;
+
+  forall_goto_functions(it, functions)  
+    if(it->second.body_available)
+    {
+      irep_table_writert body;
+
+      body.word(it->second.body.instructions.size());
+
       forall_goto_program_instructions(i_it, it->second.body)
       {
-        const goto_programt::instructiont &instruction = *i_it;
-        
-        irepconverter.reference_convert(instruction.code, out);
-        irepconverter.write_string_ref(out, instruction.function);
-        irepconverter.reference_convert(instruction.source_location, out);
-        write_gb_word(out, (long)instruction.type);
-        irepconverter.reference_convert(instruction.guard, out);        
-        irepconverter.write_string_ref(out, irep_idt()); // former event
-        write_gb_word(out, instruction.target_number);
-                
-        write_gb_word(out, instruction.targets.size());
+        const goto_programt::instructiont &instruction=*i_it;
+
+        body.irep(instruction.code);
+        body.string(instruction.function);
+        body.irep(instruction.source_location);
+        body.word(instruction.type);
+        body.irep(instruction.guard);
+        body.word(instruction.target_number);
 
+        body.word(instruction.targets.size());
         for(goto_programt::targetst::const_iterator
             t_it=instruction.targets.begin();
             t_it!=instruction.targets.end();
             t_it++)
-          write_gb_word(out, (*t_it)->target_number);
-          
-        write_gb_word(out, instruction.labels.size());
+          body.word((*t_it)->target_number);
 
+        body.word(instruction.labels.size());
         for(goto_programt::instructiont::labelst::const_iterator
             l_it=instruction.labels.begin();
             l_it!=instruction.labels.end();
             l_it++)
-          irepconverter.write_string_ref(out, *l_it);
+          body.string(*l_it);
       }
+
+      std::ostringstream body_out;
+      body.write(body_out);
+
+      bodies.push_back(std::make_pair(it->first, std::string()));
+      bodies.back().second=body_out.str();
+    }
+
+  // the index
+  {
+    irep_table_writert index;
+
+    index.word(bodies.size());
+
+    for(bodiest::const_iterator
+        it=bodies.begin();
+        it!=bodies.end();
+        it++)
+    {
+      index.string(it->first);
+      index.word(it->second.size());
     }
+
+    index.write(out);
   }
 
-  //irepconverter.output_map(f);
-  //irepconverter.output_string_map(f);  
+  // the bodies, in the order of the index
+  for(bodiest::const_iterator
+      it=bodies.begin();
+      it!=bodies.end();
+      it++)
+    out.write(it->second.data(), it->second.size());
 
   return false;
 }
@@ -170,6 +403,15 @@ bool write_goto_binary(
       out, lsymbol_table, functions,
       irepconverter);
 
+  case 3:
+    return write_goto_binary_v3(
+      out, lsymbol_table, functions,
+      irepconverter);
+
+  case 4:
+    return write_goto_binary_v4(
+      out, lsymbol_table, functions);
+
   default: 
     throw "Unknown goto binary version";
   }
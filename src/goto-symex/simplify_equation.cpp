@@ -0,0 +1,102 @@
+/*******************************************************************\
+
+Module: Word-level Simplification of the SSA Equation
+
+\*******************************************************************/
+
+#include <util/replace_symbol.h>
+#include <util/simplify_expr.h>
+
+#include "simplify_equation.h"
+
+/*******************************************************************\
+
+Function: propagate
+
+  Inputs:
+
+ Outputs: true if the expression changed
+
+ Purpose: replaces the variables with known values, and
+          simplifies if that did anything
+
+\*******************************************************************/
+
+static bool propagate(
+  const replace_symbolt &values,
+  const namespacet &ns,
+  exprt &expr)
+{
+  if(values.expr_map.empty() ||
+     values.replace(expr))
+    return false;
+
+  simplify(expr, ns);
+  return true;
+}
+
+/*******************************************************************\
+
+Function: simplify_equation
+
+  Inputs:
+
+ Outputs: the number of steps that changed
+
+ Purpose:
+
+\*******************************************************************/
+
+unsigned simplify_equation(
+  symex_target_equationt &equation,
+  const namespacet &ns)
+{
+  replace_symbolt values;
+  unsigned changed=0;
+
+  for(symex_target_equationt::SSA_stepst::iterator
+      it=equation.SSA_steps.begin();
+      it!=equation.SSA_steps.end();
+      it++)
+  {
+    if(it->ignore)
+      continue;
+
+    bool step_changed=propagate(values, ns, it->guard);
+
+    if(it->is_assignment())
+    {
+      // leave the left-hand side alone
+      if(it->cond_expr.id()!=ID_equal ||
+         it->cond_expr.operands().size()!=2)
+        continue;
+
+      exprt &rhs=it->cond_expr.op1();
+
+      if(propagate(values, ns, rhs))
+      {
+        it->ssa_rhs=rhs;
+        step_changed=true;
+      }
+
+      if((rhs.is_constant() || rhs.id()==ID_symbol) &&
+         it->cond_expr.op0().id()==ID_symbol &&
+         it->cond_expr.op0().type()==rhs.type())
+        values.insert(
+          to_symbol_expr(it->cond_expr.op0()).get_identifier(), rhs);
+    }
+    else if(it->is_assume() ||
+            it->is_assert() ||
+            it->is_goto() ||
+            it->is_constraint())
+    {
+      if(propagate(values, ns, it->cond_expr))
+        step_changed=true;
+    }
+
+    if(step_changed)
+      changed++;
+  }
+
+  return changed;
+}
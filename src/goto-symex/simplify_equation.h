@@ -0,0 +1,25 @@
+/*******************************************************************\
+
+Module: Word-level Simplification of the SSA Equation
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_SYMEX_SIMPLIFY_EQUATION_H
+#define CPROVER_GOTO_SYMEX_SIMPLIFY_EQUATION_H
+
+#include "symex_target_equation.h"
+
+// Assignments in SSA form are equalities that hold whatever the
+// guard, and every variable has at most one of them.  Variables
+// that are assigned a constant or another variable are replaced by
+// it in the steps that follow, across steps, which the propagation
+// done while running symex does not do after merges and for
+// values that only become constant once simplified.  The
+// assignments themselves are kept, which keeps the trace intact.
+// Returns the number of steps that changed.
+
+unsigned simplify_equation(
+  symex_target_equationt &equation,
+  const namespacet &ns);
+
+#endif
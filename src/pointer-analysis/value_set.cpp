@@ -8,6 +8,7 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <cassert>
 #include <ostream>
+#include <list>
 
 #include <util/symbol_table.h>
 #include <util/simplify_expr.h>
@@ -85,10 +86,7 @@ value_sett::entryt &value_sett::get_entry(
   else
     index=e.identifier;
 
-  std::pair<valuest::iterator, bool> r=
-    values.insert(std::pair<idt, entryt>(index, e));
-
-  return r.first->second;
+  return values.insert(index, e);
 }
 
 /*******************************************************************\
@@ -144,14 +142,18 @@ void value_sett::output(
   const namespacet &ns,
   std::ostream &out) const
 {
-  for(valuest::const_iterator
-      v_it=values.begin();
-      v_it!=values.end();
+  // the shards are by hash, print by name
+  valuest::sorted_entriest sorted;
+  values.get_sorted(sorted);
+
+  for(valuest::sorted_entriest::const_iterator
+      v_it=sorted.begin();
+      v_it!=sorted.end();
       v_it++)
   {
     irep_idt identifier, display_name;
     
-    const entryt &e=v_it->second;
+    const entryt &e=(*v_it)->second;
   
     if(has_prefix(id2string(e.identifier), "value_set::dynamic_object"))
     {
@@ -275,38 +277,84 @@ Function: value_sett::make_union
 
 bool value_sett::make_union(const value_sett::valuest &new_values)
 {
+  if(values.shares_with(new_values))
+    return false;
+
   bool result=false;
   
-  valuest::iterator v_it=values.begin();
-
-  for(valuest::const_iterator
-      it=new_values.begin();
-      it!=new_values.end();
-      ) // no it++
+  for(std::size_t shard=0; shard<valuest::number_of_shards; shard++)
   {
-    if(v_it==values.end() || it->first<v_it->first)
+    // skip what the two have in common
+    if(values.shares_shard(new_values, shard))
+      continue;
+
+    const valuest::shardt &new_entries=new_values.read_shard(shard);
+
+    if(new_entries.empty())
+      continue;
+
+    const valuest::shardt &entries=values.read_shard(shard);
+
+    if(entries.empty())
     {
-      values.insert(v_it, *it);
+      values.share_shard(new_values, shard);
       result=true;
-      it++;
       continue;
     }
-    else if(v_it->first<it->first)
+    
+    // collect the changes first, to only copy the shard
+    // if there are any
+    typedef std::list<std::pair<idt, entryt> > changest;
+    changest changes;
+  
+    valuest::shardt::const_iterator v_it=entries.begin();
+
+    for(valuest::shardt::const_iterator
+        it=new_entries.begin();
+        it!=new_entries.end();
+        ) // no it++
     {
+      if(v_it==entries.end() || it->first<v_it->first)
+      {
+        changes.push_back(*it);
+        it++;
+        continue;
+      }
+      else if(v_it->first<it->first)
+      {
+        v_it++;
+        continue;
+      }
+      
+      assert(v_it->first==it->first);
+        
+      const entryt &e=v_it->second;
+      const entryt &new_e=it->second;
+      
+      object_mapt object_map=e.object_map;
+
+      if(make_union(object_map, new_e.object_map))
+      {
+        changes.push_back(std::pair<idt, entryt>(it->first, e));
+        changes.back().second.object_map.swap(object_map);
+      }
+
       v_it++;
-      continue;
+      it++;
     }
-    
-    assert(v_it->first==it->first);
-      
-    entryt &e=v_it->second;
-    const entryt &new_e=it->second;
-    
-    if(make_union(e.object_map, new_e.object_map))
-      result=true;
 
-    v_it++;
-    it++;
+    if(changes.empty())
+      continue;
+
+    result=true;
+
+    valuest::shardt &dest=values.write_shard(shard);
+
+    for(changest::iterator
+        c_it=changes.begin();
+        c_it!=changes.end();
+        c_it++)
+      dest[c_it->first]=c_it->second;
   }
   
   return result;
@@ -326,6 +374,15 @@ Function: value_sett::make_union
 
 bool value_sett::make_union(object_mapt &dest, const object_mapt &src) const
 {
+  if(dest.get_d()==src.get_d())
+    return false;
+
+  if(dest.read().empty())
+  {
+    dest=src;
+    return !src.read().empty();
+  }
+
   bool result=false;
   
   for(object_map_dt::const_iterator it=src.read().begin();
@@ -1401,8 +1458,12 @@ void value_sett::do_free(
   }
   
   // mark these as 'may be invalid'
-  // this, unfortunately, destroys the sharing
-  for(valuest::iterator v_it=values.begin();
+  // the changes are collected first, as writing to the
+  // values invalidates the iterators
+  typedef std::list<std::pair<idt, object_mapt> > changest;
+  changest changes;
+
+  for(valuest::const_iterator v_it=values.begin();
       v_it!=values.end();
       v_it++)
   {
@@ -1442,7 +1503,18 @@ void value_sett::do_free(
     }
     
     if(changed)
-      v_it->second.object_map=new_object_map;
+      changes.push_back(
+        std::pair<idt, object_mapt>(v_it->first, new_object_map));
+  }
+
+  for(changest::const_iterator
+      c_it=changes.begin();
+      c_it!=changes.end();
+      c_it++)
+  {
+    entryt *e=values.find_for_write(c_it->first);
+    assert(e!=NULL);
+    e->object_map=c_it->second;
   }
 }
 
@@ -13,6 +13,7 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <util/mp_arith.h>
 #include <util/reference_counting.h>
+#include <util/sharing_map.h>
 
 #include "object_numbering.h"
 #include "value_sets.h"
@@ -112,11 +113,9 @@ public:
   
   typedef std::set<exprt> expr_sett;
 
-  #ifdef USE_DSTRING   
-  typedef std::map<idt, entryt> valuest;
-  #else
-  typedef hash_map_cont<idt, entryt, string_hash> valuest;
-  #endif
+  // copies share the entries, which makes the copies
+  // of the symex state at branches cheap
+  typedef sharing_mapt<idt, entryt, irep_id_hash> valuest;
 
   void get_value_set(
     const exprt &expr,
@@ -85,18 +85,21 @@ void value_set_analysist::convert(
     xmlt &i=dest.new_element("instruction");
     i.new_element()=::xml(location);
     
-    for(value_sett::valuest::const_iterator
-        v_it=value_set.values.begin();
-        v_it!=value_set.values.end();
+    value_sett::valuest::sorted_entriest sorted;
+    value_set.values.get_sorted(sorted);
+
+    for(value_sett::valuest::sorted_entriest::const_iterator
+        v_it=sorted.begin();
+        v_it!=sorted.end();
         v_it++)
     {
       xmlt &var=i.new_element("variable");
       var.new_element("identifier").data=
-        id2string(v_it->first);
+        id2string((*v_it)->first);
 
       #if 0      
       const value_sett::expr_sett &expr_set=
-        v_it->second.expr_set();
+        (*v_it)->second.expr_set();
       
       for(value_sett::expr_sett::const_iterator
           e_it=expr_set.begin();
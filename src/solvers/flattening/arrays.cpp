@@ -10,6 +10,7 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <cassert>
 #include <iostream>
+#include <map>
 
 #include <langapi/language_util.h>
 
@@ -374,64 +375,207 @@ void arrayst::add_array_constraints()
 
 /*******************************************************************\
 
+Function: split_index
+
+  Inputs: an index
+
+ Outputs: false if the index is a bit-vector 'base+offset' or
+          'base-offset' with a constant offset, or just a constant
+          (with nil base) or just something else (with offset 0)
+
+ Purpose: two such indices with the same base and different
+          offsets can't be equal, modulo the width
+
+\*******************************************************************/
+
+static bool split_index(
+  const exprt &index,
+  exprt &base,
+  mp_integer &offset)
+{
+  const typet &type=index.type();
+
+  if(type.id()!=ID_signedbv && type.id()!=ID_unsignedbv)
+    return true;
+
+  if(index.is_constant())
+  {
+    base.make_nil();
+    return to_integer(index, offset);
+  }
+
+  if((index.id()==ID_plus || index.id()==ID_minus) &&
+     index.operands().size()==2 &&
+     index.op0().type()==type &&
+     index.op1().type()==type)
+  {
+    if(index.op1().is_constant() &&
+       !to_integer(index.op1(), offset))
+    {
+      base=index.op0();
+      if(index.id()==ID_minus) offset.negate();
+      return false;
+    }
+
+    if(index.id()==ID_plus &&
+       index.op0().is_constant() &&
+       !to_integer(index.op0(), offset))
+    {
+      base=index.op1();
+      return false;
+    }
+  }
+
+  base=index;
+  offset=0;
+  return false;
+}
+
+/*******************************************************************\
+
 Function: arrayst::add_array_Ackermann_constraints
 
   Inputs:
 
  Outputs:
 
- Purpose:
+ Purpose: a[i]=a[j] if i=j, for each pair of indices of an array,
+          except for pairs that are known to differ: constants,
+          and the same base with different constant offsets
 
 \*******************************************************************/
 
 void arrayst::add_array_Ackermann_constraints()
 {
-  // this is quadratic!
+  // The indices are grouped by type and base, and then by the
+  // offset modulo the width.  Within a base, only indices with
+  // the same offset are paired.  Indices with different bases
+  // are all paired, which is quadratic if the bases differ.
+
+  typedef std::vector<const exprt *> indicest;
+  typedef std::map<mp_integer, indicest> offsetst;
+  typedef std::map<std::pair<typet, exprt>, offsetst> basest;
 
   // iterate over arrays
   for(std::size_t i=0; i<arrays.size(); i++)
   {
     const index_sett &index_set=index_map[arrays.find_number(i)];
-    
-    // iterate over indices, 2x!
+
+    if(index_set.size()<2)
+      continue;
+
+    basest bases;
+
     for(index_sett::const_iterator
-        i1=index_set.begin();
-        i1!=index_set.end();
-        i1++)
-      for(index_sett::const_iterator
-          i2=index_set.begin();
-          i2!=index_set.end();
-          i2++)
-        if(i1!=i2)
+        it=index_set.begin();
+        it!=index_set.end();
+        it++)
+    {
+      exprt base;
+      mp_integer offset;
+
+      if(split_index(*it, base, offset))
+      {
+        // a group of its own
+        base=*it;
+        offset=0;
+      }
+      else
+      {
+        mp_integer modulus=
+          power(2, to_bitvector_type(it->type()).get_width());
+        offset%=modulus;
+        if(offset<0) offset+=modulus;
+      }
+
+      bases[std::make_pair(it->type(), base)][offset].push_back(&*it);
+    }
+
+    for(basest::const_iterator
+        b_it1=bases.begin();
+        b_it1!=bases.end();
+        b_it1++)
+    {
+      // the same base and offset; constants are all different
+      if(b_it1->first.second.is_not_nil())
+        for(offsetst::const_iterator
+            o_it=b_it1->second.begin();
+            o_it!=b_it1->second.end();
+            o_it++)
         {
-          if(i1->is_constant() && i2->is_constant())
-            continue;
+          const indicest &indices=o_it->second;
 
-          // index equality
-          equal_exprt indices_equal(*i1, *i2);
+          for(std::size_t k1=0; k1<indices.size(); k1++)
+            for(std::size_t k2=k1+1; k2<indices.size(); k2++)
+              add_array_Ackermann_constraint(
+                arrays[i], *indices[k1], *indices[k2]);
+        }
 
-          if(indices_equal.op0().type()!=
-             indices_equal.op1().type())
-          {
-            indices_equal.op1().
-              make_typecast(indices_equal.op0().type());
-          }
+      // different bases
+      basest::const_iterator b_it2=b_it1;
+
+      for(b_it2++; b_it2!=bases.end(); b_it2++)
+        for(offsetst::const_iterator
+            o_it1=b_it1->second.begin();
+            o_it1!=b_it1->second.end();
+            o_it1++)
+          for(offsetst::const_iterator
+              o_it2=b_it2->second.begin();
+              o_it2!=b_it2->second.end();
+              o_it2++)
+            for(std::size_t k1=0; k1<o_it1->second.size(); k1++)
+              for(std::size_t k2=0; k2<o_it2->second.size(); k2++)
+              {
+                const exprt &i1=*o_it1->second[k1];
+                const exprt &i2=*o_it2->second[k2];
+
+                if(!i1.is_constant() || !i2.is_constant())
+                  add_array_Ackermann_constraint(arrays[i], i1, i2);
+              }
+    }
+  }
+}
 
-          index_exprt index_expr1;
-          index_expr1.type()=ns.follow(arrays[i].type()).subtype();
-          index_expr1.array()=arrays[i];
-          index_expr1.index()=*i1;
+/*******************************************************************\
 
-          index_exprt index_expr2=index_expr1;
-          index_expr2.index()=*i2;
+Function: arrayst::add_array_Ackermann_constraint
 
-          equal_exprt values_equal(index_expr1, index_expr2);
+  Inputs: an array and two of its indices
 
-          lazy_constraintt lazy(ARRAY_ACKERMANN, 
-                                implies_exprt(indices_equal, values_equal));
-          add_array_constraint(lazy, true); //added lazily
-        }
+ Outputs:
+
+ Purpose: a[i1]=a[i2] if i1=i2
+
+\*******************************************************************/
+
+void arrayst::add_array_Ackermann_constraint(
+  const exprt &array,
+  const exprt &i1,
+  const exprt &i2)
+{
+  // index equality
+  equal_exprt indices_equal(i1, i2);
+
+  if(indices_equal.op0().type()!=
+     indices_equal.op1().type())
+  {
+    indices_equal.op1().
+      make_typecast(indices_equal.op0().type());
   }
+
+  index_exprt index_expr1;
+  index_expr1.type()=ns.follow(array.type()).subtype();
+  index_expr1.array()=array;
+  index_expr1.index()=i1;
+
+  index_exprt index_expr2=index_expr1;
+  index_expr2.index()=i2;
+
+  equal_exprt values_equal(index_expr1, index_expr2);
+
+  lazy_constraintt lazy(ARRAY_ACKERMANN, 
+                        implies_exprt(indices_equal, values_equal));
+  add_array_constraint(lazy, true); //added lazily
 }
 
 /*******************************************************************\
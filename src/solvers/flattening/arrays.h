@@ -89,6 +89,8 @@ protected:
   // adds all the constraints eagerly
   void add_array_constraints();
   void add_array_Ackermann_constraints();
+  void add_array_Ackermann_constraint(
+    const exprt &array, const exprt &i1, const exprt &i2);
   void add_array_constraints_equality(const index_sett &index_set, const array_equalityt &array_equality);
   void add_array_constraints(const index_sett &index_set, const exprt &expr);
   void add_array_constraints(const index_sett &index_set, const array_equalityt &array_equality);
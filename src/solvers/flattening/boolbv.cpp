@@ -68,10 +68,11 @@ bool boolbvt::literal(
 
       const boolbv_mapt::map_entryt &map_entry=it_m->second;
       
-      assert(bit<map_entry.literal_map.size());
-      if(!map_entry.literal_map[bit].is_set) return true;
+      assert(bit<map_entry.width);
+      literalt l=map.get_literal(map_entry, bit);
+      if(!boolbv_mapt::is_set(l)) return true;
 
-      dest=map_entry.literal_map[bit].l;
+      dest=l;
       return false;
     }
     else if(expr.id()==ID_index)
@@ -364,7 +365,7 @@ void boolbvt::convert_bitvector(const exprt &expr, bvt &bv)
     bvt bv0, bv1;
     convert_bitvector(expr.op0(), bv0);
     convert_bitvector(expr.op1(), bv1);
-    float_utilst float_utils(prop);
+    float_utilst float_utils(prop, float_cache);
     float_utils.spec=to_floatbv_type(expr.type());
     bv=expr.id()==ID_float_debug1?
       float_utils.debug1(bv0, bv1):
@@ -627,7 +628,7 @@ literalt boolbvt::convert_rest(const exprt &expr)
     
     if(expr.op0().type().id()==ID_floatbv)
     {
-      float_utilst float_utils(prop);
+      float_utilst float_utils(prop, float_cache);
       float_utils.spec=to_floatbv_type(expr.op0().type());
       return float_utils.is_NaN(bv);
     }
@@ -643,7 +644,7 @@ literalt boolbvt::convert_rest(const exprt &expr)
     
     if(expr.op0().type().id()==ID_floatbv)
     {
-      float_utilst float_utils(prop);
+      float_utilst float_utils(prop, float_cache);
       float_utils.spec=to_floatbv_type(expr.op0().type());
       return prop.land(
         prop.lnot(float_utils.is_infinity(bv)),
@@ -661,7 +662,7 @@ literalt boolbvt::convert_rest(const exprt &expr)
     
     if(expr.op0().type().id()==ID_floatbv)
     {
-      float_utilst float_utils(prop);
+      float_utilst float_utils(prop, float_cache);
       float_utils.spec=to_floatbv_type(expr.op0().type());
       return float_utils.is_infinity(bv);
     }
@@ -677,7 +678,7 @@ literalt boolbvt::convert_rest(const exprt &expr)
     
     if(expr.op0().type().id()==ID_floatbv)
     {
-      float_utilst float_utils(prop);
+      float_utilst float_utils(prop, float_cache);
       float_utils.spec=to_floatbv_type(expr.op0().type());
       return float_utils.is_normal(bv);
     }
@@ -862,12 +863,45 @@ void boolbvt::print_assignment(std::ostream &out) const
       it++)
   {
     out << it->first << "="
-        << it->second.get_value(prop) << '\n';
+        << map.get_value(it->second) << '\n';
   }
 }
 
 /*******************************************************************\
 
+Function: boolbvt::memory_statistics
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: reports the memory taken by the literals of the
+          expressions and symbols, roughly, and how often
+          floating-point circuits were shared
+
+\*******************************************************************/
+
+void boolbvt::memory_statistics()
+{
+  std::size_t cache_bytes=bv_cache.size()*sizeof(bv_cachet::value_type);
+
+  for(bv_cachet::const_iterator
+      it=bv_cache.begin();
+      it!=bv_cache.end();
+      it++)
+    cache_bytes+=it->second.capacity()*sizeof(literalt);
+
+  statistics() << "Flattening: " << bv_cache.size() << " expressions ("
+               << cache_bytes/1024 << " KiB), " << map.mapping.size()
+               << " symbols (" << map.memory()/1024 << " KiB)" << eom;
+
+  if(float_cache.hits!=0 || float_cache.misses!=0)
+    statistics() << "Floating-point circuits: " << float_cache.misses
+                 << " built, " << float_cache.hits << " reused" << eom;
+}
+
+/*******************************************************************\
+
 Function: boolbvt::build_offset_map
 
   Inputs:
@@ -18,11 +18,14 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/expr.h>
 #include <util/byte_operators.h>
 
+#include "../floatbv/float_utils.h"
+
 #include "bv_utils.h"
 #include "boolbv_width.h"
 #include "boolbv_map.h"
 #include "arrays.h"
 #include "functions.h"
+#include "flatten_byte_operators.h"
 
 class extractbit_exprt;
 class extractbits_exprt;
@@ -55,6 +58,7 @@ public:
   {
     SUB::clear_cache();
     bv_cache.clear();
+    float_cache.clear();
   }
 
   virtual void post_process()
@@ -62,6 +66,7 @@ public:
     post_process_quantifiers();
     functions.post_process();
     SUB::post_process();
+    memory_statistics();
   }
   
   // get literals for variables/expressions, if available
@@ -109,6 +114,12 @@ protected:
   typedef hash_map_cont<const exprt, bvt, irep_hash> bv_cachet;
   bv_cachet bv_cache;
 
+  // floating-point circuits, by the literals of the operands
+  float_utilst::cachet float_cache;
+
+  // does not depend on the literals, hence kept by clear_cache()
+  flattened_byte_operatorst flattened_byte_operators;
+
   bool type_conversion(
     const typet &src_type, const bvt &src,
     const typet &dest_type, bvt &dest);
@@ -237,6 +248,8 @@ protected:
   quantifier_listt quantifier_list;
   
   void post_process_quantifiers();
+
+  void memory_statistics();
   
   typedef std::vector<unsigned> offset_mapt;
   void build_offset_map(const struct_typet &src, offset_mapt &dest);
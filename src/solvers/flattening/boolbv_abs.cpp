@@ -55,7 +55,7 @@ void boolbvt::convert_abs(const exprt &expr, bvt &bv)
   }
   else if(bvtype==IS_FLOAT)
   {
-    float_utilst float_utils(prop);
+    float_utilst float_utils(prop, float_cache);
     float_utils.spec=to_floatbv_type(expr.type());
     bv=float_utils.abs(op_bv);
     return;
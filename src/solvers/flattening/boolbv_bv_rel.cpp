@@ -46,7 +46,7 @@ literalt boolbvt::convert_bv_rel(const exprt &expr)
     {
       if(bvtype0==IS_FLOAT)
       {
-        float_utilst float_utils(prop);
+        float_utilst float_utils(prop, float_cache);
         float_utils.spec=to_floatbv_type(op0.type());
 
         if(rel==ID_le)
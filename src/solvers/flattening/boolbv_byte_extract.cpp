@@ -137,6 +137,9 @@ void boolbvt::convert_byte_extract(
   else
   {
     unsigned bytes=op_bv.size()/byte_width;
+
+    // only offsets that are a multiple of this are possible
+    const unsigned alignment=offset_alignment(offset);
     
     if(prop.has_set_to())
     {
@@ -154,7 +157,7 @@ void boolbvt::convert_byte_extract(
       bvt equal_bv;
       equal_bv.resize(width);
 
-      for(unsigned i=0; i<bytes; i++)
+      for(unsigned i=0; i<bytes; i+=alignment)
       {
         equality.rhs()=from_integer(i, constant_type);
 
@@ -177,7 +180,7 @@ void boolbvt::convert_byte_extract(
 
       typet constant_type(offset.type()); // type of index operand
       
-      for(unsigned i=0; i<bytes; i++)
+      for(unsigned i=0; i<bytes; i+=alignment)
       {
         equality.rhs()=from_integer(i, constant_type);
           
@@ -14,6 +14,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/endianness_map.h>
 
 #include "boolbv.h"
+#include "flatten_byte_operators.h"
 
 /*******************************************************************\
 
@@ -98,17 +99,20 @@ void boolbvt::convert_byte_update(
     return;
   }
 
-  // byte_update with variable index
-  for(std::size_t offset=0; offset<bv.size(); offset+=byte_width)
+  // byte_update with variable index, where only offsets that
+  // are a multiple of the alignment are possible
+  const std::size_t step=offset_alignment(offset_expr)*byte_width;
+
+  endianness_mapt map_op(op.type(), little_endian, ns);
+  endianness_mapt map_value(value.type(), little_endian, ns);
+
+  for(std::size_t offset=0; offset<bv.size(); offset+=step)
   {
     // index condition
     equal_exprt equality;
     equality.lhs()=offset_expr;
     equality.rhs()=from_integer(offset/byte_width, offset_expr.type());
     literalt equal=convert(equality);
-    
-    endianness_mapt map_op(op.type(), little_endian, ns);
-    endianness_mapt map_value(value.type(), little_endian, ns);
 
     for(std::size_t bit=0; bit<update_width; bit++)
       if(offset+bit<bv.size())
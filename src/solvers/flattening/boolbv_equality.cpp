@@ -45,7 +45,7 @@ literalt boolbvt::convert_equality(const equal_exprt &expr)
 
     if(has_byte_operator(expr))
     {
-      exprt tmp=flatten_byte_operators(expr, ns);
+      exprt tmp=flatten_byte_operators(expr, ns, flattened_byte_operators);
       //std::cout << "X: " << from_expr(ns, "", tmp) << std::endl;
       return record_array_equality(to_equal_expr(tmp));
     }
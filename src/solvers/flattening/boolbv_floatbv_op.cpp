@@ -45,7 +45,7 @@ void boolbvt::convert_floatbv_typecast(
     return;
   }
 
-  float_utilst float_utils(prop);
+  float_utilst float_utils(prop, float_cache);
   
   float_utils.set_rounding_mode(convert_bv(op1));
   
@@ -120,7 +120,7 @@ void boolbvt::convert_floatbv_op(const exprt &expr, bvt &bv)
     throw "float op with mixed types";
   }
 
-  float_utilst float_utils(prop);
+  float_utilst float_utils(prop, float_cache);
   
   float_utils.set_rounding_mode(bv2);
 
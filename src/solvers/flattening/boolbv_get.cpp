@@ -55,12 +55,12 @@ exprt boolbvt::get(const exprt &expr) const
 
       for(unsigned bit_nr=0; bit_nr<width; bit_nr++)
       {
-        assert(bit_nr<map_entry.literal_map.size());
+        literalt l=map.get_literal(map_entry, bit_nr);
 
-        if(map_entry.literal_map[bit_nr].is_set)
+        if(boolbv_mapt::is_set(l))
         {
           unknown[bit_nr]=false;
-          bv[bit_nr]=map_entry.literal_map[bit_nr].l;
+          bv[bit_nr]=l;
         }
         else
         {
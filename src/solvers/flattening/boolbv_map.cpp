@@ -21,7 +21,7 @@ Author: Daniel Kroening, kroening@kroening.com
 
 /*******************************************************************\
 
-Function: boolbv_mapt::map_entryt::get_value
+Function: boolbv_mapt::get_value
 
   Inputs:
 
@@ -31,20 +31,20 @@ Function: boolbv_mapt::map_entryt::get_value
 
 \*******************************************************************/
 
-std::string boolbv_mapt::map_entryt::get_value(const propt &prop) const
+std::string boolbv_mapt::get_value(const map_entryt &map_entry) const
 {
   std::string result;
   
-  result.reserve(literal_map.size());
+  result.reserve(map_entry.width);
 
-  for(unsigned i=0; i<literal_map.size(); i++)
+  for(unsigned i=0; i<map_entry.width; i++)
   {
     char ch='*';
+    literalt l=get_literal(map_entry, i);
 
-    if(literal_map[i].is_set)
+    if(is_set(l))
     {
-      tvt value=prop.l_get(literal_map[i].l);
-
+      tvt value=prop.l_get(l);
       if(value.is_true())
         ch='1';
       else if(value.is_false())
@@ -89,11 +89,8 @@ boolbv_mapt::map_entryt &boolbv_mapt::get_map_entry(
     map_entry.type=type;
     map_entry.width=boolbv_width(type);
     map_entry.bvtype=get_bvtype(type);
-    map_entry.literal_map.resize(map_entry.width);
   }
 
-  assert(map_entry.literal_map.size()==map_entry.width);
-
   return map_entry;
 }
 
@@ -120,6 +117,34 @@ void boolbv_mapt::show() const
 
 /*******************************************************************\
 
+Function: boolbv_mapt::is_range
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: true if the literals are consecutive variables
+
+\*******************************************************************/
+
+bool boolbv_mapt::is_range(const bvt &literals)
+{
+  if(literals.empty() ||
+     literals.front().is_constant() ||
+     literals.front().sign())
+    return false;
+
+  const unsigned first=literals.front().var_no();
+
+  for(unsigned bit=1; bit<literals.size(); bit++)
+    if(literals[bit]!=literalt(first+bit, false))
+      return false;
+
+  return true;
+}
+
+/*******************************************************************\
+
 Function: boolbv_mapt::get_literals
 
   Inputs:
@@ -139,26 +164,52 @@ void boolbv_mapt::get_literals(
   map_entryt &map_entry=get_map_entry(identifier, type);
   
   assert(literals.size()==width);
-  assert(map_entry.literal_map.size()==width);
-  
+  assert(map_entry.width==width);
+
+  if(map_entry.is_range())
+  {
+    for(unsigned bit=0; bit<width; bit++)
+      literals[bit]=literalt(map_entry.first.var_no()+bit, false);
+
+    return;
+  }
+
+  if(map_entry.offset==map_entryt::no_offset)
+  {
+    // all new
+    literals=prop.new_variables(width);
+
+    if(is_range(literals))
+      map_entry.first=literals.front();
+    else
+    {
+      map_entry.offset=pool.size();
+      pool.insert(pool.end(), literals.begin(), literals.end());
+    }
+
+    #ifdef DEBUG
+    std::cout << "NEW: " << identifier << ":0-" << width-1
+              << "=" << literals.front() << "..." << std::endl;
+    #endif
+
+    return;
+  }
+
   Forall_literals(it, literals)
   {
     literalt &l=*it;
     const unsigned bit=it-literals.begin();
 
-    assert(bit<map_entry.literal_map.size());
-    map_bitt &mb=map_entry.literal_map[bit];
+    literalt &mb=pool[map_entry.offset+bit];
 
-    if(mb.is_set)
+    if(is_set(mb))
     {
-      l=mb.l;
+      l=mb;
       continue;
     }
 
     l=prop.new_variable();
-
-    mb.is_set=true;
-    mb.l=l;
+    mb=l;
 
     #ifdef DEBUG
     std::cout << "NEW: " << identifier << ":" << bit
@@ -186,6 +237,23 @@ void boolbv_mapt::set_literals(
 {
   map_entryt &map_entry=get_map_entry(identifier, type);
 
+  assert(literals.size()<=map_entry.width);
+
+  if(map_entry.offset==map_entryt::no_offset &&
+     !map_entry.is_range())
+  {
+    // all new
+    if(literals.size()==map_entry.width &&
+       is_range(literals))
+    {
+      map_entry.first=literals.front();
+      return;
+    }
+
+    map_entry.offset=pool.size();
+    pool.resize(pool.size()+map_entry.width);
+  }
+
   forall_literals(it, literals)
   {
     const literalt &literal=*it;
@@ -194,17 +262,38 @@ void boolbv_mapt::set_literals(
     assert(literal.is_constant() ||
            literal.var_no()<prop.no_variables());
 
-    assert(bit<map_entry.literal_map.size());
-    map_bitt &mb=map_entry.literal_map[bit];
+    if(map_entry.is_range())
+    {
+      prop.set_equal(get_literal(map_entry, bit), literal);
+      continue;
+    }
 
-    if(mb.is_set)
+    literalt &mb=pool[map_entry.offset+bit];
+
+    if(is_set(mb))
     {
-      prop.set_equal(mb.l, literal);
+      prop.set_equal(mb, literal);
       continue;
     }
 
-    mb.is_set=true;
-    mb.l=literal;
+    mb=literal;
   }
 }
 
+/*******************************************************************\
+
+Function: boolbv_mapt::memory
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+std::size_t boolbv_mapt::memory() const
+{
+  return mapping.size()*sizeof(mappingt::value_type)+
+         pool.capacity()*sizeof(literalt);
+}
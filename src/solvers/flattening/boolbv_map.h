@@ -9,6 +9,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_BOOLBV_MAP_H
 #define CPROVER_BOOLBV_MAP_H
 
+#include <cassert>
 #include <vector>
 
 #include <util/hash_cont.h>
@@ -31,33 +32,59 @@ public:
   {
   }
 
-  struct map_bitt
-  {
-    map_bitt():is_set(false) { }
-    bool is_set;
-    literalt l;
-  };
-
-  typedef std::vector<map_bitt> literal_mapt;
+  // The literals of a symbol are either consecutive variables,
+  // as made by get_literals, and then only the first is kept, or
+  // they are kept in one pool that all symbols share, which saves
+  // a vector per symbol.  Bits that are not set yet are literalt().
 
   class map_entryt
   {
   public:
-    map_entryt():width(0), bvtype(IS_UNKNOWN)
+    map_entryt():
+      width(0), bvtype(IS_UNKNOWN),
+      offset(no_offset)
     {
     }
 
     unsigned width;
     bvtypet bvtype;
     typet type;
-    literal_mapt literal_map;
-    
-    std::string get_value(const propt &) const;
+
+    // the first of consecutive variables, or at offset in the pool
+    literalt first;
+    std::size_t offset;
+
+    static const std::size_t no_offset=~std::size_t(0);
+
+    inline bool is_range() const
+    {
+      return is_set(first);
+    }
   };
   
   typedef hash_map_cont<irep_idt, map_entryt, irep_id_hash> mappingt;  
   mappingt mapping;
 
+  static inline bool is_set(literalt l)
+  {
+    return l.var_no()!=literalt::unused_var_no();
+  }
+
+  // literalt() if the bit is not set
+  literalt get_literal(const map_entryt &map_entry, unsigned bit) const
+  {
+    assert(bit<map_entry.width);
+
+    if(map_entry.is_range())
+      return literalt(map_entry.first.var_no()+bit, false);
+    else if(map_entry.offset==map_entryt::no_offset)
+      return literalt();
+    else
+      return pool[map_entry.offset+bit];
+  }
+
+  std::string get_value(const map_entryt &map_entry) const;
+
   void show() const;
 
   map_entryt &get_map_entry(
@@ -74,11 +101,18 @@ public:
     const irep_idt &identifier,
     const typet &type,
     const bvt &literals);
+
+  // bytes taken by the entries and the literals
+  std::size_t memory() const;
     
 protected:
   propt &prop;
   const namespacet &ns;
   const boolbv_widtht &boolbv_width;
+
+  bvt pool;
+
+  static bool is_range(const bvt &literals);
 };
 
 #endif
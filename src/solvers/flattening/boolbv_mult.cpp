@@ -12,6 +12,36 @@ Author: Daniel Kroening, kroening@kroening.com
 
 /*******************************************************************\
 
+Function: significant_bits
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: the number of bits of an operand that matter, the ones
+          above are zero (unsigned) or copies of the sign (signed),
+          e.g., as the operand is the extension of a smaller type
+
+\*******************************************************************/
+
+static std::size_t significant_bits(
+  const bvt &op,
+  bv_utilst::representationt rep)
+{
+  std::size_t bits=op.size();
+
+  if(rep==bv_utilst::UNSIGNED)
+    while(bits>1 && op[bits-1]==const_literal(false))
+      bits--;
+  else
+    while(bits>1 && op[bits-1]==op[bits-2])
+      bits--;
+
+  return bits;
+}
+
+/*******************************************************************\
+
 Function: boolbvt::convert_mult
 
   Inputs:
@@ -102,8 +132,21 @@ void boolbvt::convert_mult(const exprt &expr, bvt &bv)
       if(op.size()!=width)
         throw "convert_mult: unexpected operand width";
 
+      // the product of an n-bit and an m-bit number fits into
+      // n+m bits, which may be much less than the width
+      std::size_t product_bits=
+        significant_bits(bv, rep)+significant_bits(op, rep);
+
       if(no_overflow)
         bv=bv_utils.multiplier_no_overflow(bv, op, rep);
+      else if(product_bits<width)
+      {
+        bvt small_bv(bv.begin(), bv.begin()+product_bits);
+        bvt small_op(op.begin(), op.begin()+product_bits);
+
+        bv=bv_utils.extension(
+          bv_utils.multiplier(small_bv, small_op, rep), width, rep);
+      }
       else
         bv=bv_utils.multiplier(bv, op, rep);
     }    
@@ -168,7 +168,7 @@ bool boolbvt::type_conversion(
     
   case IS_FLOAT: // to float
     {
-      float_utilst float_utils(prop);
+      float_utilst float_utils(prop, float_cache);
       
       switch(src_bvtype)
       {
@@ -494,7 +494,7 @@ bool boolbvt::type_conversion(
 
     if(src_bvtype==IS_FLOAT)
     {
-      float_utilst float_utils(prop);
+      float_utilst float_utils(prop, float_cache);
       float_utils.spec=to_floatbv_type(src_type);
       dest[0]=!float_utils.is_zero(src);
     }
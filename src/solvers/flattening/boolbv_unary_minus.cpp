@@ -80,7 +80,7 @@ void boolbvt::convert_unary_minus(const unary_exprt &expr, bvt &bv)
       
       if(type.subtype().id()==ID_floatbv)
       {
-        float_utilst float_utils(prop);
+        float_utilst float_utils(prop, float_cache);
         float_utils.spec=to_floatbv_type(subtype);
         tmp_result=float_utils.negate(tmp_op);
       }
@@ -110,7 +110,7 @@ void boolbvt::convert_unary_minus(const unary_exprt &expr, bvt &bv)
   else if(bvtype==IS_FLOAT && op_bvtype==IS_FLOAT)
   {
     assert(!no_overflow);
-    float_utilst float_utils(prop);
+    float_utilst float_utils(prop, float_cache);
     float_utils.spec=to_floatbv_type(expr.type());
     bv=float_utils.negate(op_bv);
     return;
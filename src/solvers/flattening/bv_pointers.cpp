@@ -311,7 +311,24 @@ void bv_pointerst::convert_pointer_type(const exprt &expr, bvt &bv)
   }
   else if(expr.id()==ID_if)
   {
-    return SUB::convert_if(to_if_expr(expr), bv);
+    const if_exprt &if_expr=to_if_expr(expr);
+
+    SUB::convert_if(if_expr, bv);
+
+    // the objects of a choice are those of the two cases
+    object_sett objects, false_objects;
+
+    if(!get_objects(convert_bv(if_expr.true_case()), objects) &&
+       !get_objects(convert_bv(if_expr.false_case()), false_objects))
+    {
+      objects.insert(false_objects.begin(), false_objects.end());
+
+      std::vector<unsigned> key;
+      object_key(bv, key);
+      possible_objects[key].swap(objects);
+    }
+
+    return;
   }
   else if(expr.id()==ID_index)
   {
@@ -793,6 +810,10 @@ Function: bv_pointerst::do_postponed
 void bv_pointerst::do_postponed(
   const postponedt &postponed)
 {
+  // the pointer cannot be equal to any other object
+  object_sett possible;
+  bool all_objects=get_objects(postponed.op, possible);
+
   if(postponed.expr.id()==ID_dynamic_object)
   {
     const pointer_logict::objectst &objects=
@@ -806,6 +827,9 @@ void bv_pointerst::do_postponed(
         it++, number++)
     {
       const exprt &expr=*it;
+
+      if(!all_objects && possible.find(number)==possible.end())
+        continue;
       
       bool is_dynamic=pointer_logic.is_dynamic_object(expr);
       
@@ -842,6 +866,9 @@ void bv_pointerst::do_postponed(
         it++, number++)
     {
       const exprt &expr=*it;
+
+      if(!all_objects && possible.find(number)==possible.end())
+        continue;
       
       mp_integer object_size;
 
@@ -887,6 +914,81 @@ void bv_pointerst::do_postponed(
 
 /*******************************************************************\
 
+Function: bv_pointerst::object_key
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: the key of a pointer in possible_objects
+
+\*******************************************************************/
+
+void bv_pointerst::object_key(
+  const bvt &bv,
+  std::vector<unsigned> &key) const
+{
+  assert(bv.size()==bits);
+
+  key.reserve(object_bits);
+
+  for(std::size_t i=0; i<object_bits; i++)
+    key.push_back(bv[offset_bits+i].get());
+}
+
+/*******************************************************************\
+
+Function: bv_pointerst::get_objects
+
+  Inputs:
+
+ Outputs: true if any object is possible
+
+ Purpose: the objects a pointer may point to
+
+\*******************************************************************/
+
+bool bv_pointerst::get_objects(
+  const bvt &bv,
+  object_sett &dest) const
+{
+  if(bv.size()!=bits)
+    return true;
+
+  // constant, as for the address of an object
+  std::size_t number=0;
+  bool is_constant=true;
+
+  for(std::size_t i=0; i<object_bits && is_constant; i++)
+  {
+    const literalt l=bv[offset_bits+i];
+
+    if(!l.is_constant())
+      is_constant=false;
+    else if(l.is_true())
+      number|=std::size_t(1)<<i;
+  }
+
+  if(is_constant)
+  {
+    dest.insert(number);
+    return false;
+  }
+
+  std::vector<unsigned> key;
+  object_key(bv, key);
+
+  possible_objectst::const_iterator it=possible_objects.find(key);
+
+  if(it==possible_objects.end())
+    return true;
+
+  dest=it->second;
+  return false;
+}
+
+/*******************************************************************\
+
 Function: bv_pointerst::post_process
 
   Inputs:
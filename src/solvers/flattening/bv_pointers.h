@@ -9,6 +9,9 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_BV_POINTERS_H
 #define CPROVER_BV_POINTERS_H
 
+#include <map>
+#include <set>
+
 #include <util/hash_cont.h>
 
 #include "boolbv.h"
@@ -63,6 +66,19 @@ protected:
   postponed_listt postponed_list;  
   
   void do_postponed(const postponedt &postponed);
+
+  // The objects a pointer may point to, as far as its structure
+  // tells: the object bits are constant, or it is a choice between
+  // pointers with known objects.  These are kept by the literals of
+  // the object bits, which are shared by pointers that are equal
+  // by construction.  The postponed constraints are only generated
+  // for these objects.
+  typedef std::set<std::size_t> object_sett;
+  typedef std::map<std::vector<unsigned>, object_sett> possible_objectst;
+  possible_objectst possible_objects;
+
+  void object_key(const bvt &bv, std::vector<unsigned> &key) const;
+  bool get_objects(const bvt &bv, object_sett &dest) const;
   
   static bool is_ptr(const typet &type)
   {
@@ -6,16 +6,90 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
+#include <algorithm>
+
 #include <util/expr.h>
 #include <util/std_types.h>
 #include <util/std_expr.h>
 #include <util/arith_tools.h>
+#include <util/base_type.h>
 #include <util/pointer_offset_size.h>
 
 #include "flatten_byte_operators.h"
 
 /*******************************************************************\
 
+Function: offset_alignment
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Only powers of two are used, as these are preserved
+          when the arithmetic on the offset wraps around.
+
+\*******************************************************************/
+
+#define MAX_OFFSET_ALIGNMENT (1u<<16)
+
+unsigned offset_alignment(const exprt &offset)
+{
+  if(offset.is_constant())
+  {
+    mp_integer value;
+    if(to_integer(offset, value))
+      return 1;
+
+    if(value==0)
+      return MAX_OFFSET_ALIGNMENT;
+
+    unsigned alignment=1;
+    while(alignment<MAX_OFFSET_ALIGNMENT && value%(alignment*2)==0)
+      alignment*=2;
+
+    return alignment;
+  }
+  else if(offset.id()==ID_mult)
+  {
+    mp_integer alignment=1;
+
+    forall_operands(it, offset)
+      alignment*=offset_alignment(*it);
+
+    if(alignment>MAX_OFFSET_ALIGNMENT)
+      return MAX_OFFSET_ALIGNMENT;
+
+    return integer2unsigned(alignment);
+  }
+  else if(offset.id()==ID_plus ||
+          offset.id()==ID_minus)
+  {
+    unsigned alignment=MAX_OFFSET_ALIGNMENT;
+
+    forall_operands(it, offset)
+      alignment=std::min(alignment, offset_alignment(*it));
+
+    return alignment;
+  }
+  else if(offset.id()==ID_typecast &&
+          offset.operands().size()==1)
+  {
+    // no narrowing
+    const typet &type=offset.type();
+    const typet &op_type=offset.op0().type();
+
+    if((type.id()==ID_signedbv || type.id()==ID_unsignedbv) &&
+       (op_type.id()==ID_signedbv || op_type.id()==ID_unsignedbv) &&
+       to_bitvector_type(type).get_width()>=
+       to_bitvector_type(op_type).get_width())
+      return offset_alignment(offset.op0());
+  }
+
+  return 1;
+}
+
+/*******************************************************************\
+
 Function: flatten_byte_extract
 
   Inputs:
@@ -105,6 +179,40 @@ exprt flatten_byte_extract(
         throw "failed to flatten non-byte array with unknown element width";
 
       mp_integer result_width=pointer_offset_size(src.type(), ns);
+
+      // word-aligned?  Then there is no need for a remainder
+      // and a shift.  The division is done on the whole offset,
+      // which stays correct if the offset arithmetic wraps around.
+      if(element_width>0 &&
+         mp_integer(offset_alignment(offset))%element_width==0)
+      {
+        mp_integer num_elements=
+          (result_width+element_width-1)/element_width;
+
+        const exprt first_index=
+          element_width==1?offset:
+          div_exprt(offset, from_integer(element_width, offset_type));
+
+        if(num_elements==1 &&
+           result_width==element_width &&
+           base_type_eq(src.type(), element_type, ns))
+          return index_exprt(root, first_index, src.type());
+
+        concatenation_exprt concat(
+          unsignedbv_typet(integer2unsigned(element_width*8*num_elements)));
+
+        for(mp_integer i=num_elements; i>0; --i)
+        {
+          plus_exprt index(first_index, from_integer(i-1, offset_type));
+          concat.copy_to_operands(index_exprt(root, index));
+        }
+
+        exprt tmp(src.id(), src.type());
+        tmp.copy_to_operands(concat, from_integer(0, offset_type));
+
+        return tmp;
+      }
+
       mp_integer num_elements=(element_width+result_width-2)/element_width+1;
 
       // compute new root and offset
@@ -355,27 +463,59 @@ Function: flatten_byte_operators
 
  Outputs:
 
- Purpose:
+ Purpose: flattens every distinct byte operator once, which
+          keeps the sharing of the result
 
 \*******************************************************************/
 
-exprt flatten_byte_operators(const exprt &src, const namespacet &ns)
+exprt flatten_byte_operators(
+  const exprt &src,
+  const namespacet &ns,
+  flattened_byte_operatorst &flattened)
 {
   exprt tmp=src;
   
-  // destroys any sharing, should use hash table
   Forall_operands(it, tmp)
   {
-    exprt tmp=flatten_byte_operators(*it, ns);
+    exprt tmp=flatten_byte_operators(*it, ns, flattened);
     it->swap(tmp);
   }
 
-  if(src.id()==ID_byte_update_little_endian ||
-     src.id()==ID_byte_update_big_endian)
-    return flatten_byte_update(tmp, ns);
-  else if(src.id()==ID_byte_extract_little_endian ||
-          src.id()==ID_byte_extract_big_endian)
-    return flatten_byte_extract(tmp, ns);
-  else
+  if(src.id()!=ID_byte_update_little_endian &&
+     src.id()!=ID_byte_update_big_endian &&
+     src.id()!=ID_byte_extract_little_endian &&
+     src.id()!=ID_byte_extract_big_endian)
     return tmp;
+
+  std::pair<flattened_byte_operatorst::iterator, bool> entry=
+    flattened.insert(std::make_pair(tmp, exprt()));
+
+  if(entry.second)
+  {
+    if(src.id()==ID_byte_update_little_endian ||
+       src.id()==ID_byte_update_big_endian)
+      entry.first->second=flatten_byte_update(tmp, ns);
+    else
+      entry.first->second=flatten_byte_extract(tmp, ns);
+  }
+
+  return entry.first->second;
+}
+
+/*******************************************************************\
+
+Function: flatten_byte_operators
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+exprt flatten_byte_operators(const exprt &src, const namespacet &ns)
+{
+  flattened_byte_operatorst flattened;
+  return flatten_byte_operators(src, ns, flattened);
 }
@@ -10,11 +10,26 @@ Author: Daniel Kroening, kroening@kroening.com
 #define CPROVER_FLATTEN_BYTE_OPERATORS_H
 
 #include <util/expr.h>
+#include <util/hash_cont.h>
+#include <util/irep_hash.h>
 #include <util/namespace.h>
 
 exprt flatten_byte_extract(const exprt &src, const namespacet &ns);
 exprt flatten_byte_update(const exprt &src, const namespacet &ns);
 exprt flatten_byte_operators(const exprt &src, const namespacet &ns);
+
+// the byte operators flattened so far, valid as long as
+// the namespace stays the same
+typedef hash_map_cont<exprt, exprt, irep_hash> flattened_byte_operatorst;
+
+exprt flatten_byte_operators(
+  const exprt &src,
+  const namespacet &ns,
+  flattened_byte_operatorst &flattened);
 bool has_byte_operator(const exprt &src);
 
+// a power of two that the value of an offset is known to be a
+// multiple of, from its structure, e.g., 4 for i*12+8
+unsigned offset_alignment(const exprt &offset);
+
 #endif
@@ -362,6 +362,15 @@ bvt float_utilst::add_sub(
   const bvt &src2,
   bool subtract)
 {
+  cache_keyt key;
+  cache_key(subtract?SUBTRACT:ADD, key);
+  cache_key(src1, key);
+  cache_key(src2, key);
+
+  bvt cached_result;
+  if(cached(key, cached_result))
+    return cached_result;
+
   unbiased_floatt unpacked1=unpack(src1);
   unbiased_floatt unpacked2=unpack(src2);
 
@@ -490,7 +499,7 @@ bvt float_utilst::add_sub(
   return pack(bias(result));
   #endif
 
-  return rounder(result);
+  return remember(key, rounder(result));
 }
 
 /*******************************************************************\
@@ -542,6 +551,15 @@ Function: float_utilst::mul
 
 bvt float_utilst::mul(const bvt &src1, const bvt &src2)
 {
+  cache_keyt key;
+  cache_key(MULTIPLY, key);
+  cache_key(src1, key);
+  cache_key(src2, key);
+
+  bvt cached_result;
+  if(cached(key, cached_result))
+    return cached_result;
+
   // unpack
   const unbiased_floatt unpacked1=unpack(src1);
   const unbiased_floatt unpacked2=unpack(src2);
@@ -575,8 +593,8 @@ bvt float_utilst::mul(const bvt &src1, const bvt &src2)
   {
     bvt NaN_cond;
 
-    NaN_cond.push_back(is_NaN(src1));
-    NaN_cond.push_back(is_NaN(src2));
+    NaN_cond.push_back(unpacked1.NaN);
+    NaN_cond.push_back(unpacked2.NaN);
 
     // infinity * 0 is NaN!
     NaN_cond.push_back(prop.land(unpacked1.zero, unpacked2.infinity));
@@ -585,7 +603,7 @@ bvt float_utilst::mul(const bvt &src1, const bvt &src2)
     result.NaN=prop.lor(NaN_cond);
   }
 
-  return rounder(result);
+  return remember(key, rounder(result));
 }
 
 /*******************************************************************\
@@ -602,6 +620,15 @@ Function: float_utilst::div
 
 bvt float_utilst::div(const bvt &src1, const bvt &src2)
 {
+  cache_keyt key;
+  cache_key(DIVIDE, key);
+  cache_key(src1, key);
+  cache_key(src2, key);
+
+  bvt cached_result;
+  if(cached(key, cached_result))
+    return cached_result;
+
   // unpack
   const unbiased_floatt unpacked1=unpack(src1);
   const unbiased_floatt unpacked2=unpack(src2);
@@ -673,7 +700,7 @@ bvt float_utilst::div(const bvt &src1, const bvt &src2)
   result.fraction=bv_utils.select(force_zero,
     bv_utils.zeros(result.fraction.size()), result.fraction);
 
-  return rounder(result);
+  return remember(key, rounder(result));
 }
 
 /*******************************************************************\
@@ -1240,6 +1267,21 @@ bvt float_utilst::rounder(const unbiased_floatt &src)
   //           some exponent without bias
   // outgoing: rounded, with right size, with hidden bit, bias
 
+  cache_keyt key;
+  cache_key(ROUND, key);
+  if(cache!=NULL)
+  {
+    key.push_back(src.sign.get());
+    key.push_back(src.NaN.get());
+    key.push_back(src.infinity.get());
+  }
+  cache_key(src.fraction, key);
+  cache_key(src.exponent, key);
+
+  bvt cached_result;
+  if(cached(key, cached_result))
+    return cached_result;
+
   bvt aligned_fraction=src.fraction,
       aligned_exponent=src.exponent;
 
@@ -1271,7 +1313,7 @@ bvt float_utilst::rounder(const unbiased_floatt &src)
   round_fraction(result);
   round_exponent(result);
 
-  return pack(bias(result));
+  return remember(key, pack(bias(result)));
 }
 
 /*******************************************************************\
@@ -1625,6 +1667,24 @@ float_utilst::unbiased_floatt float_utilst::unpack(const bvt &src)
 {
   assert(src.size()==spec.width());
 
+  cache_keyt key;
+
+  if(cache!=NULL)
+  {
+    cache_key(UNPACK, key);
+    cache_key(src, key);
+
+    cachet::unpackedt::const_iterator it=cache->unpacked.find(key);
+
+    if(it!=cache->unpacked.end())
+    {
+      cache->hits++;
+      return it->second;
+    }
+
+    cache->misses++;
+  }
+
   unbiased_floatt result;
 
   result.sign=sign_bit(src);
@@ -1647,6 +1707,9 @@ float_utilst::unbiased_floatt float_utilst::unpack(const bvt &src)
   result.zero=is_zero(src);
   result.NaN=is_NaN(src);
 
+  if(cache!=NULL)
+    cache->unpacked[key]=result;
+
   return result;
 }
 
@@ -1804,3 +1867,107 @@ bvt float_utilst::debug2(
   return op0;
 }
 
+/*******************************************************************\
+
+Function: float_utilst::cache_key
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: starts the key with the operation and what the
+          circuit depends on besides the operands
+
+\*******************************************************************/
+
+void float_utilst::cache_key(operationt operation, cache_keyt &key) const
+{
+  if(cache==NULL)
+    return;
+
+  key.push_back(operation);
+  key.push_back(spec.f);
+  key.push_back(spec.e);
+
+  // unpacking does not depend on the rounding mode
+  if(operation!=UNPACK)
+  {
+    key.push_back(rounding_mode_bits.round_to_even.get());
+    key.push_back(rounding_mode_bits.round_to_zero.get());
+    key.push_back(rounding_mode_bits.round_to_plus_inf.get());
+    key.push_back(rounding_mode_bits.round_to_minus_inf.get());
+  }
+}
+
+/*******************************************************************\
+
+Function: float_utilst::cache_key
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: adds an operand to the key
+
+\*******************************************************************/
+
+void float_utilst::cache_key(const bvt &src, cache_keyt &key) const
+{
+  if(cache==NULL)
+    return;
+
+  key.push_back(src.size());
+
+  for(bvt::const_iterator it=src.begin(); it!=src.end(); it++)
+    key.push_back(it->get());
+}
+
+/*******************************************************************\
+
+Function: float_utilst::cached
+
+  Inputs:
+
+ Outputs: true if the result is in the cache
+
+ Purpose:
+
+\*******************************************************************/
+
+bool float_utilst::cached(const cache_keyt &key, bvt &dest)
+{
+  if(cache==NULL)
+    return false;
+
+  cachet::resultst::const_iterator it=cache->results.find(key);
+
+  if(it==cache->results.end())
+  {
+    cache->misses++;
+    return false;
+  }
+
+  cache->hits++;
+  dest=it->second;
+  return true;
+}
+
+/*******************************************************************\
+
+Function: float_utilst::remember
+
+  Inputs:
+
+ Outputs: the result
+
+ Purpose: puts the result into the cache, if there is one
+
+\*******************************************************************/
+
+bvt float_utilst::remember(const cache_keyt &key, const bvt &result)
+{
+  if(cache!=NULL)
+    cache->results[key]=result;
+
+  return result;
+}
@@ -9,6 +9,8 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_FLOAT_UTILS_H
 #define CPROVER_FLOAT_UTILS_H
 
+#include <map>
+
 #include <util/ieee_float.h>
 
 #include <solvers/flattening/bv_utils.h>
@@ -63,9 +65,21 @@ public:
   
   rounding_mode_bitst rounding_mode_bits;
 
+  class cachet;
+
   explicit float_utilst(propt &_prop):
     prop(_prop),
-    bv_utils(_prop)
+    bv_utils(_prop),
+    cache(NULL)
+  {
+  }
+
+  // circuits are shared through the cache, which must
+  // only be used with '_prop'
+  float_utilst(propt &_prop, cachet &_cache):
+    prop(_prop),
+    bv_utils(_prop),
+    cache(&_cache)
   {
   }
   
@@ -135,6 +149,7 @@ public:
 protected:
   propt &prop;
   bv_utilst bv_utils;
+  cachet *cache;
 
   // unpacked
   virtual void normalization_shift(bvt &fraction, bvt &exponent);
@@ -199,6 +214,48 @@ protected:
     const bvt &op,
     const bvt &dist,
     literalt &sticky);
+
+  // for the cache
+  typedef enum { ADD, SUBTRACT, MULTIPLY, DIVIDE, ROUND, UNPACK } operationt;
+  typedef std::vector<unsigned> cache_keyt;
+
+  void cache_key(operationt, cache_keyt &) const;
+  void cache_key(const bvt &, cache_keyt &) const;
+  bool cached(const cache_keyt &, bvt &dest);
+  bvt remember(const cache_keyt &, const bvt &result);
+};
+
+// What an operation yields only depends on the literals of its
+// operands, the format and the rounding mode, and how an operand
+// is unpacked only on its literals and the format.  The cache
+// keeps both, so that the circuit for an operation is built once,
+// and every value is unpacked once, however many operations it
+// is used in.  Classes that build different circuits, such as
+// float_approximationt, must not use a cache.
+
+class float_utilst::cachet
+{
+public:
+  cachet():hits(0), misses(0)
+  {
+  }
+
+  unsigned hits, misses;
+
+  void clear()
+  {
+    results.clear();
+    unpacked.clear();
+  }
+
+protected:
+  friend class float_utilst;
+
+  typedef std::map<cache_keyt, bvt> resultst;
+  resultst results;
+
+  typedef std::map<cache_keyt, unbiased_floatt> unpackedt;
+  unpackedt unpacked;
 };
 
 #endif
@@ -11,6 +11,9 @@ Author: Daniel Kroening, kroening@kroening.com
 #include "literal_expr.h"
 #include "cover_goals.h"
 
+// with assumptions, the goals are asked for in chunks of this size
+#define GOALS_PER_ITERATION 1000
+
 /*******************************************************************\
 
 Function: cover_goalst::~cover_goalst
@@ -125,12 +128,33 @@ void cover_goalst::operator()()
 {
   _iterations=_number_covered=0;
   
-  decision_proceduret::resultt dec_result;
-  
   // We use incremental solving, so need to freeze some variables
   // to prevent them from being eliminated.      
   freeze_goal_variables();
 
+  if(prop_conv.has_set_assumptions())
+    cover_with_assumptions();
+  else
+    cover_with_constraints();
+}
+
+/*******************************************************************\
+
+Function: cover_goalst::cover_with_constraints
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Try to cover all goals, adding a clause over all
+          remaining goals in each iteration
+
+\*******************************************************************/
+
+void cover_goalst::cover_with_constraints()
+{
+  decision_proceduret::resultt dec_result;
+  
   do
   {
     // We want (at least) one of the remaining goals, please!
@@ -158,3 +182,79 @@ void cover_goalst::operator()()
         number_covered()<size());
 }
 
+/*******************************************************************\
+
+Function: cover_goalst::cover_with_assumptions
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Try to cover all goals, asking for one of a chunk of
+          the remaining goals in each iteration by means of an
+          assumption, so that nothing is added permanently.  Once
+          that is unsatisfiable, none of the goals in the chunk
+          can be covered, and we go on with the next chunk.
+
+\*******************************************************************/
+
+void cover_goalst::cover_with_assumptions()
+{
+  // the goals before this are covered or can't be
+  goalst::const_iterator chunk_begin=goals.begin();
+
+  while(chunk_begin!=goals.end() &&
+        number_covered()<size())
+  {
+    exprt::operandst disjuncts;
+    goalst::const_iterator chunk_end=chunk_begin;
+
+    for(; chunk_end!=goals.end() &&
+          disjuncts.size()<GOALS_PER_ITERATION;
+        chunk_end++)
+      if(!chunk_end->covered && !chunk_end->condition.is_false())
+        disjuncts.push_back(literal_exprt(chunk_end->condition));
+
+    // 'false' if there are no disjuncts
+    literalt wanted=prop_conv.convert(disjunction(disjuncts));
+
+    if(wanted.is_false())
+    {
+      chunk_begin=chunk_end;
+      continue;
+    }
+
+    // We want (at least) one of the goals in the chunk, please!
+    _iterations++;
+
+    bvt assumptions;
+
+    if(!wanted.is_true())
+    {
+      prop_conv.set_frozen(wanted);
+      assumptions.push_back(wanted);
+    }
+
+    prop_conv.set_assumptions(assumptions);
+
+    switch(prop_conv.dec_solve())
+    {
+    case decision_proceduret::D_UNSATISFIABLE:
+      // none of these can be covered
+      chunk_begin=chunk_end;
+      break;
+
+    case decision_proceduret::D_SATISFIABLE:
+      // mark the goals we got, and notify observers
+      mark(); 
+      break;
+
+    default:
+      prop_conv.set_assumptions(bvt());
+      error() << "decision procedure has failed" << eom;
+      return;
+    }
+  }
+
+  prop_conv.set_assumptions(bvt());
+}
@@ -100,6 +100,9 @@ private:
   void mark();
   void constraint();
   void freeze_goal_variables();
+
+  void cover_with_constraints();
+  void cover_with_assumptions();
 };
 
 #endif
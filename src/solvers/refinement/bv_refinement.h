@@ -60,8 +60,18 @@ protected:
 
     // the kind of under- or over-approximation    
     unsigned under_state, over_state;
+
+    // for floating-point, how many of the most-significant
+    // fraction bits of the operands the under-approximation
+    // leaves free
+    unsigned fraction_bits;
+
+    // for multiplication, how many of the least-significant
+    // bits of the result are constrained
+    unsigned product_bits;
     
-    approximationt():under_state(0), over_state(0)
+    approximationt():
+      under_state(0), over_state(0), fraction_bits(0), product_bits(0)
     {
     }
     
@@ -86,6 +96,8 @@ protected:
   void check_SAT();
   void check_UNSAT();
   bool progress;
+
+  void arithmetic_statistics();
   
   // we refine the theory of arrays
   virtual void post_process_arrays();
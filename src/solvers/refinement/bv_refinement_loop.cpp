@@ -99,6 +99,7 @@ decision_proceduret::resultt bv_refinementt::dec_solve()
       {
         status() << "BV-Refinement: got SAT, and it simulates => SAT" << eom;
         status() << "Total iterations: " << iteration << eom;
+        arithmetic_statistics();
         return D_SATISFIABLE;
       }
       else
@@ -111,6 +112,7 @@ decision_proceduret::resultt bv_refinementt::dec_solve()
       {
         status() << "BV-Refinement: got UNSAT, and the proof passes => UNSAT" << eom;
         status() << "Total iterations: " << iteration << eom;
+        arithmetic_statistics();
         return D_UNSATISFIABLE;
       }
       else
@@ -6,6 +6,9 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
+#include <map>
+#include <algorithm>
+
 #include <util/i2string.h>
 #include <util/bv_arithmetic.h>
 #include <util/ieee_float.h>
@@ -21,6 +24,7 @@ Author: Daniel Kroening, kroening@kroening.com
 // Parameters
 #define MAX_INTEGER_UNDERAPPROX 3
 #define MAX_FLOAT_UNDERAPPROX 10
+#define MIN_LAZY_PRODUCT_BITS 8
 
 /*******************************************************************\
 
@@ -314,7 +318,7 @@ void bv_refinementt::check_SAT(approximationt &a)
     if(a.over_state<max_node_refinement)
     {
       bvt r;
-      float_utilst float_utils(prop);
+      float_utilst float_utils(prop, float_cache);
       float_utils.spec=spec;
       float_utils.rounding_mode_bits.set(rounding_mode);
       
@@ -341,7 +345,7 @@ void bv_refinementt::check_SAT(approximationt &a)
       a.over_state=MAX_STATE;
     
       bvt r;
-      float_utilst float_utils(prop);
+      float_utilst float_utils(prop, float_cache);
       float_utils.spec=spec;
       float_utils.rounding_mode_bits.set(rounding_mode);
 
@@ -369,7 +373,7 @@ void bv_refinementt::check_SAT(approximationt &a)
     assert(a.expr.operands().size()==2);
 
     // already full interpretation?
-    if(a.over_state>0) return;
+    if(a.over_state==MAX_STATE) return;
   
     bv_spect spec(type);
     bv_arithmetict o0(spec), o1(spec);
@@ -394,9 +398,43 @@ void bv_refinementt::check_SAT(approximationt &a)
     if(o0.pack()==a.result_value) // ok
       return;
 
-    if(a.over_state==0)
+    const std::size_t width=a.result_bv.size();
+    std::size_t product_bits=width;
+
+    if(a.expr.id()==ID_mult)
+    {
+      // The lowest k bits of a product only depend on the lowest
+      // k bits of the operands, signed or not.  We constrain at
+      // least twice as many as the last time, and at least up to
+      // the lowest bit that is wrong.
+      const std::string expected=integer2binary(o0.pack(), width);
+      const std::string actual=integer2binary(a.result_value, width);
+
+      std::size_t wrong=0;
+      while(expected[width-1-wrong]==actual[width-1-wrong])
+        wrong++;
+
+      product_bits=std::max(
+        std::size_t(MIN_LAZY_PRODUCT_BITS), std::size_t(a.product_bits)*2);
+
+      while(product_bits<=wrong)
+        product_bits*=2;
+    }
+
+    if(product_bits<width)
+    {
+      const bvt op0(a.op0_bv.begin(), a.op0_bv.begin()+product_bits);
+      const bvt op1(a.op1_bv.begin(), a.op1_bv.begin()+product_bits);
+      const bvt result(a.result_bv.begin(), a.result_bv.begin()+product_bits);
+
+      bv_utils.set_equal(
+        bv_utils.multiplier(op0, op1, bv_utilst::UNSIGNED), result);
+
+      a.product_bits=product_bits;
+    }
+    else
     {
-      // we give up right away and add the full interpretation
+      // add the full interpretation
       bvt r;
       if(a.expr.id()==ID_mult)
       {
@@ -420,9 +458,10 @@ void bv_refinementt::check_SAT(approximationt &a)
         assert(0);
 
       bv_utils.set_equal(r, a.result_bv);
+
+      a.product_bits=width;
+      a.over_state=MAX_STATE;
     }
-    else
-      assert(0);
   }
   else if(type.id()==ID_fixedbv)
   {
@@ -474,7 +513,7 @@ void bv_refinementt::check_UNSAT(approximationt &a)
 
     a.under_assumptions.reserve(a.op0_bv.size()+a.op1_bv.size());
 
-    float_utilst float_utils(prop);
+    float_utilst float_utils(prop, float_cache);
     float_utils.spec=spec;
 
     // the fraction without hidden bit
@@ -491,22 +530,24 @@ void bv_refinementt::check_UNSAT(approximationt &a)
 
       for(unsigned i=0; i<fraction1.size(); i++)
         a.add_under_assumption(prop.lnot(fraction1[i]));
+
+      a.fraction_bits=0;
     }
     else
     {
       // now fraction: make this grow quadratically
       unsigned x=a.under_state*a.under_state;
   
-      if(x>=MAX_FLOAT_UNDERAPPROX && x>=a.result_bv.size())
+      if(a.under_state>=MAX_FLOAT_UNDERAPPROX || x>=fraction0.size())
       {
         // make it free altogether, this guarantees progress
+        a.fraction_bits=fraction0.size();
       }
       else
       {
-        // set x bits of both exponent and mantissa free
-        // need to start with most-significant bits
+        // set the x most-significant bits of the fractions free,
+        // i.e., the operands have a precision of x bits
 
-        #if 0
         for(unsigned i=x; i<fraction0.size(); i++)
           a.add_under_assumption(prop.lnot(
             fraction0[fraction0.size()-i-1]));
@@ -514,7 +555,8 @@ void bv_refinementt::check_UNSAT(approximationt &a)
         for(unsigned i=x; i<fraction1.size(); i++)
           a.add_under_assumption(prop.lnot(
             fraction1[fraction1.size()-i-1]));
-        #endif
+
+        a.fraction_bits=x;
       }
     }
   }
@@ -579,6 +621,8 @@ Function: bv_refinementt::initialize
 void bv_refinementt::initialize(approximationt &a)
 {
   a.over_state=a.under_state=0;
+  a.fraction_bits=0;
+  a.product_bits=0;
 
   a.under_assumptions.reserve(a.op0_bv.size()+a.op1_bv.size());
 
@@ -670,3 +714,87 @@ std::string bv_refinementt::approximationt::as_string() const
   #endif
 }
 
+/*******************************************************************\
+
+Function: bv_refinementt::arithmetic_statistics
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: reports how far the floating-point operations and the
+          multiplications have been refined
+
+\*******************************************************************/
+
+void bv_refinementt::arithmetic_statistics()
+{
+  // by number of fraction bits of the operands
+  typedef std::map<unsigned, unsigned> precisionst;
+  precisionst precisions;
+  unsigned floatbv_ops=0, full=0, unrestricted=0;
+
+  // by number of bits of the product that are constrained
+  precisionst product_bits;
+  unsigned mult_ops=0, full_mult=0;
+
+  for(approximationst::const_iterator
+      a_it=approximations.begin();
+      a_it!=approximations.end();
+      a_it++)
+  {
+    const irep_idt &type_id=a_it->expr.type().id();
+
+    if(type_id==ID_floatbv)
+    {
+      floatbv_ops++;
+
+      if(a_it->over_state==MAX_STATE)
+        full++;
+
+      if(a_it->under_assumptions.empty())
+        unrestricted++;
+      else
+        precisions[a_it->fraction_bits]++;
+    }
+    else if(a_it->expr.id()==ID_mult &&
+            (type_id==ID_signedbv || type_id==ID_unsignedbv))
+    {
+      mult_ops++;
+
+      if(a_it->over_state==MAX_STATE)
+        full_mult++;
+      else
+        product_bits[a_it->product_bits]++;
+    }
+  }
+
+  if(floatbv_ops!=0)
+  {
+    statistics() << "Floating-point operations: " << floatbv_ops
+                 << ", " << full << " with the full circuit" << eom;
+
+    for(precisionst::const_iterator
+        it=precisions.begin();
+        it!=precisions.end();
+        it++)
+      statistics() << "  " << it->second << " with operands of "
+                   << it->first << " fraction bits" << eom;
+
+    statistics() << "  " << unrestricted
+                 << " with unrestricted operands" << eom;
+  }
+
+  if(mult_ops!=0)
+  {
+    statistics() << "Multiplications: " << mult_ops
+                 << ", " << full_mult << " with the full circuit" << eom;
+
+    for(precisionst::const_iterator
+        it=product_bits.begin();
+        it!=product_bits.end();
+        it++)
+      statistics() << "  " << it->second << " with the lowest "
+                   << it->first << " bits of the product" << eom;
+  }
+}
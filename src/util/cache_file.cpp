@@ -0,0 +1,115 @@
+/*******************************************************************\
+
+Module: Files Shared Between Runs
+
+\*******************************************************************/
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <sstream>
+
+#include "cache_file.h"
+
+/*******************************************************************\
+
+Function: fnv_hasht::str
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+std::string fnv_hasht::str() const
+{
+  std::ostringstream result;
+  result << std::hex << hash;
+  return result.str();
+}
+
+/*******************************************************************\
+
+Function: cache_file_writert::cache_file_writert
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: the process id and a counter make the temporary name
+          unique among all processes that write the file
+
+\*******************************************************************/
+
+cache_file_writert::cache_file_writert(const std::string &_file_name):
+  file_name(_file_name),
+  committed(false)
+{
+  static unsigned counter=0;
+
+  std::ostringstream tmp_name;
+  tmp_name << file_name << '.' << getpid() << '.' << counter++ << ".part";
+  tmp_file_name=tmp_name.str();
+
+  stream.open(tmp_file_name.c_str(), std::ios::binary);
+}
+
+/*******************************************************************\
+
+Function: cache_file_writert::~cache_file_writert
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+cache_file_writert::~cache_file_writert()
+{
+  if(!committed)
+  {
+    if(stream.is_open())
+      stream.close();
+
+    remove(tmp_file_name.c_str());
+  }
+}
+
+/*******************************************************************\
+
+Function: cache_file_writert::commit
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool cache_file_writert::commit()
+{
+  if(!stream.is_open())
+    return true;
+
+  stream.close();
+
+  if(stream.fail())
+    return true;
+
+  // replaces what another process may have written in the meantime
+  if(rename(tmp_file_name.c_str(), file_name.c_str())!=0)
+    return true;
+
+  committed=true;
+  return false;
+}
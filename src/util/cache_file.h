@@ -0,0 +1,71 @@
+/*******************************************************************\
+
+Module: Files Shared Between Runs
+
+\*******************************************************************/
+
+#ifndef CPROVER_CACHE_FILE_H
+#define CPROVER_CACHE_FILE_H
+
+#include <fstream>
+#include <string>
+
+// FNV-1a, 64 bits, for naming a file after what its contents
+// depend on
+
+class fnv_hasht
+{
+public:
+  fnv_hasht():hash(14695981039346656037ULL)
+  {
+  }
+
+  void add(const char *data, std::size_t size)
+  {
+    for(std::size_t i=0; i<size; i++)
+    {
+      hash^=(unsigned char)data[i];
+      hash*=1099511628211ULL;
+    }
+  }
+
+  inline void add(const std::string &s)
+  {
+    add(s.data(), s.size());
+  }
+
+  // in hex
+  std::string str() const;
+
+protected:
+  unsigned long long hash;
+};
+
+// A file that other processes may read, or write, at the same
+// time.  The contents go to a file in the same directory whose
+// name is unique to this process, and which is renamed once it
+// is complete, so that a reader sees the file either complete
+// or not at all.  The temporary file is removed unless commit()
+// succeeds.
+
+class cache_file_writert
+{
+public:
+  explicit cache_file_writert(const std::string &_file_name);
+  ~cache_file_writert();
+
+  inline std::ostream &out()
+  {
+    return stream;
+  }
+
+  // true on error, in which case the file is not written
+  bool commit();
+
+protected:
+  std::string file_name, tmp_file_name;
+  std::ofstream stream;
+  bool committed;
+};
+
+#endif
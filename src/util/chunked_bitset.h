@@ -0,0 +1,294 @@
+/*******************************************************************\
+
+Module: Sets of Non-Negative Integers as Tagged Bit Words
+
+\*******************************************************************/
+
+#ifndef CPROVER_CHUNKED_BITSET_H
+#define CPROVER_CHUNKED_BITSET_H
+
+#include <vector>
+#include <iterator>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+// A set of non-negative integers, stored as a sorted vector of
+// 64-bit words that are tagged with their position.  Words that
+// are zero are not stored, which keeps sets over large, sparsely
+// used universes small, while union is done a word at a time.
+
+class chunked_bitsett
+{
+public:
+  typedef unsigned long long wordt;
+  typedef std::pair<std::size_t, wordt> chunkt;
+  typedef std::vector<chunkt> chunkst;
+
+  static const std::size_t bits_per_word=64;
+
+  class const_iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef std::size_t value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const std::size_t *pointer;
+    typedef std::size_t reference;
+
+    inline const_iterator(
+      chunkst::const_iterator _it,
+      chunkst::const_iterator _end):
+      it(_it), end(_end), word(_it==_end?0:_it->second)
+    {
+    }
+
+    inline std::size_t operator*() const
+    {
+      assert(word!=0);
+      return it->first*bits_per_word+lowest_bit(word);
+    }
+
+    inline const_iterator &operator++()
+    {
+      assert(word!=0);
+      word&=word-1; // clear lowest bit
+
+      if(word==0)
+      {
+        ++it;
+        if(it!=end) word=it->second;
+      }
+
+      return *this;
+    }
+
+    inline const_iterator operator++(int)
+    {
+      const_iterator tmp=*this;
+      ++(*this);
+      return tmp;
+    }
+
+    inline bool operator==(const const_iterator &other) const
+    {
+      return it==other.it && word==other.word;
+    }
+
+    inline bool operator!=(const const_iterator &other) const
+    {
+      return !(*this==other);
+    }
+
+  protected:
+    chunkst::const_iterator it, end;
+    wordt word;
+  };
+
+  inline const_iterator begin() const
+  {
+    return const_iterator(chunks.begin(), chunks.end());
+  }
+
+  inline const_iterator end() const
+  {
+    return const_iterator(chunks.end(), chunks.end());
+  }
+
+  inline bool empty() const
+  {
+    return chunks.empty();
+  }
+
+  inline void clear()
+  {
+    chunks.clear();
+  }
+
+  inline void swap(chunked_bitsett &other)
+  {
+    chunks.swap(other.chunks);
+  }
+
+  std::size_t size() const
+  {
+    std::size_t result=0;
+
+    for(chunkst::const_iterator it=chunks.begin();
+        it!=chunks.end();
+        it++)
+      for(wordt w=it->second; w!=0; w&=w-1)
+        result++;
+
+    return result;
+  }
+
+  bool contains(std::size_t value) const
+  {
+    chunkst::const_iterator it=find_chunk(value/bits_per_word);
+    return it!=chunks.end() &&
+           it->first==value/bits_per_word &&
+           (it->second&bit(value))!=0;
+  }
+
+  // returns true iff the value is new
+  bool insert(std::size_t value)
+  {
+    std::size_t index=value/bits_per_word;
+    chunkst::iterator it=find_chunk(index);
+
+    if(it==chunks.end() || it->first!=index)
+    {
+      chunks.insert(it, chunkt(index, bit(value)));
+      return true;
+    }
+
+    if((it->second&bit(value))!=0)
+      return false;
+
+    it->second|=bit(value);
+    return true;
+  }
+
+  // returns true iff the value was present
+  bool erase(std::size_t value)
+  {
+    std::size_t index=value/bits_per_word;
+    chunkst::iterator it=find_chunk(index);
+
+    if(it==chunks.end() || it->first!=index ||
+       (it->second&bit(value))==0)
+      return false;
+
+    it->second&=~bit(value);
+    if(it->second==0) chunks.erase(it);
+
+    return true;
+  }
+
+  // union, returns true iff there is s.th. new
+  bool merge(const chunked_bitsett &other)
+  {
+    if(other.chunks.empty())
+      return false;
+
+    if(chunks.empty())
+    {
+      chunks=other.chunks;
+      return true;
+    }
+
+    bool result=false;
+    std::size_t missing=0;
+
+    // first, the words present in both, in place
+    chunkst::iterator it=chunks.begin();
+    for(chunkst::const_iterator
+        ito=other.chunks.begin();
+        ito!=other.chunks.end();
+        ++ito)
+    {
+      while(it!=chunks.end() && it->first<ito->first)
+        ++it;
+
+      if(it==chunks.end() || ito->first<it->first)
+        missing++;
+      else
+      {
+        wordt w=it->second|ito->second;
+        if(w!=it->second)
+        {
+          it->second=w;
+          result=true;
+        }
+        ++it;
+      }
+    }
+
+    if(missing==0)
+      return result;
+
+    // then add the words that are only in 'other'
+    chunkst merged;
+    merged.reserve(chunks.size()+missing);
+
+    it=chunks.begin();
+    for(chunkst::const_iterator
+        ito=other.chunks.begin();
+        ito!=other.chunks.end();
+        ++ito)
+    {
+      while(it!=chunks.end() && it->first<ito->first)
+        merged.push_back(*it++);
+
+      if(it==chunks.end() || ito->first<it->first)
+        merged.push_back(*ito);
+      else
+        merged.push_back(*it++);
+    }
+
+    merged.insert(merged.end(), it, chunks.end());
+    chunks.swap(merged);
+
+    return true;
+  }
+
+  inline bool operator==(const chunked_bitsett &other) const
+  {
+    return chunks==other.chunks;
+  }
+
+  inline bool operator!=(const chunked_bitsett &other) const
+  {
+    return chunks!=other.chunks;
+  }
+
+protected:
+  chunkst chunks;
+
+  static inline wordt bit(std::size_t value)
+  {
+    return ((wordt)1)<<(value%bits_per_word);
+  }
+
+  static inline std::size_t lowest_bit(wordt w)
+  {
+    #ifdef __GNUC__
+    return __builtin_ctzll(w);
+    #else
+    std::size_t result=0;
+    while((w&1)==0) { w>>=1; result++; }
+    return result;
+    #endif
+  }
+
+  // first chunk with an index not less than 'index'
+  chunkst::iterator find_chunk(std::size_t index)
+  {
+    chunkst::iterator first=chunks.begin();
+    std::size_t count=chunks.size();
+
+    while(count>0)
+    {
+      std::size_t step=count/2;
+      chunkst::iterator it=first+step;
+
+      if(it->first<index)
+      {
+        first=++it;
+        count-=step+1;
+      }
+      else
+        count=step;
+    }
+
+    return first;
+  }
+
+  chunkst::const_iterator find_chunk(std::size_t index) const
+  {
+    return const_cast<chunked_bitsett *>(this)->find_chunk(index);
+  }
+};
+
+#endif
@@ -100,11 +100,14 @@ void guardt::add(const exprt &expr)
     return;
   }
 
-  if(expr.is_true())
+  if(expr.is_true() || is_false())
   {
   }
   else
+  {
     guard_list.push_back(expr);
+    cached=false;
+  }
 }
 
 /*******************************************************************\
@@ -128,6 +131,7 @@ guardt &operator -= (guardt &g1, const guardt &g2)
         g1.guard_list.front()==*it2)
   {
     g1.guard_list.pop_front();
+    g1.cached=false;
     it2++;
   }
 
@@ -136,6 +140,29 @@ guardt &operator -= (guardt &g1, const guardt &g2)
 
 /*******************************************************************\
 
+Function: is_negation
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: true if one is syntactically the negation of the other
+
+\*******************************************************************/
+
+static bool is_negation(const exprt &a, const exprt &b)
+{
+  if(a.id()==ID_not && a.operands().size()==1)
+    return a.op0()==b;
+  else if(b.id()==ID_not && b.operands().size()==1)
+    return b.op0()==a;
+  else
+    return (a.is_true() && b.is_false()) ||
+           (a.is_false() && b.is_true());
+}
+
+/*******************************************************************\
+
 Function: operator |=
 
   Inputs:
@@ -149,7 +176,7 @@ Function: operator |=
 guardt &operator |= (guardt &g1, const guardt &g2)
 {
   if(g2.is_false()) return g1;
-  if(g1.is_false()) { g1.guard_list=g2.guard_list; return g1; }
+  if(g1.is_false()) { g1=g2; return g1; }
 
   // find common prefix  
   guardt::guard_listt::iterator it1=g1.guard_list.begin();
@@ -171,22 +198,51 @@ guardt &operator |= (guardt &g1, const guardt &g2)
 
   // end of common prefix
   exprt and_expr1, and_expr2;
-  and_expr1=g1.as_expr(it1);
-  and_expr2=g2.as_expr(it2);
-  
-  g1.guard_list.erase(it1, g1.guard_list.end());
-  
-  exprt tmp(and_expr2);
-  tmp.make_not();
-  
-  if(tmp!=and_expr1)
+
+  if(it1!=g1.guard_list.end() &&
+     is_negation(*it1, *it2))
   {
-    if(and_expr1.is_true() || and_expr2.is_true())
+    // (c && A) || (!c && B) is A if A and B are the same, and
+    // c || B if A is true, as with an if without an else
+    guardt::guard_listt::const_iterator next1=it1, next2=it2;
+    next1++;
+    next2++;
+
+    and_expr1=g1.as_expr(next1);
+    and_expr2=g2.as_expr(next2);
+
+    if(and_expr1==and_expr2)
     {
     }
+    else if(and_expr1.is_true())
+      and_expr1=*it1;
+    else if(and_expr2.is_true())
+      and_expr2=*it2;
     else
-      g1.add(or_exprt(and_expr1, and_expr2));
+    {
+      and_expr1=g1.as_expr(it1);
+      and_expr2=g2.as_expr(it2);
+    }
   }
+  else
+  {
+    and_expr1=g1.as_expr(it1);
+    and_expr2=g2.as_expr(it2);
+  }
+  
+  g1.guard_list.erase(it1, g1.guard_list.end());
+  g1.cached=false;
+  
+  if(is_negation(and_expr1, and_expr2))
+  {
+  }
+  else if(and_expr1.is_true() || and_expr2.is_true())
+  {
+  }
+  else if(and_expr1==and_expr2)
+    g1.add(and_expr1);
+  else
+    g1.add(or_exprt(and_expr1, and_expr2));
   
   return g1;
 }
@@ -212,27 +268,6 @@ std::ostream &operator << (std::ostream &out, const guardt &g)
 
 /*******************************************************************\
 
-Function: guardt::is_false
-
-  Inputs:
-
- Outputs:
-
- Purpose:
-
-\*******************************************************************/
-
-bool guardt::is_false() const
-{
-  forall_guard(it, guard_list)
-    if(it->is_false())
-      return true;
-      
-  return false;
-}
-
-/*******************************************************************\
-
 Function: guardt::make_false
 
   Inputs:
@@ -248,5 +283,6 @@ void guardt::make_false()
   guard_list.clear();
   guard_list.push_back(exprt());
   guard_list.back()=false_exprt();
+  cached=false;
 }
 
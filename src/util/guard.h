@@ -10,12 +10,23 @@ Author: Daniel Kroening, kroening@kroening.com
 #define CPROVER_GUARD_H
 
 #include <iosfwd>
+#include <algorithm>
 
 #include "expr.h"
 
+// The conjuncts are kept in a list.  The conjunction of all of
+// them is built once and then kept until the guard changes, so
+// that all the steps that symex records under the same guard share
+// one expression.  Once a conjunct is false, nothing more is added,
+// which keeps the false one at the end of the list.
+
 class guardt
 {
 public:
+  guardt():cached(false)
+  {
+  }
+
   typedef expr_listt guard_listt;
   typedef guard_listt::size_type size_type;
 
@@ -33,18 +44,28 @@ public:
 
   exprt as_expr() const
   {
-    return as_expr(guard_list.begin());
+    if(!cached)
+    {
+      cached_expr=as_expr(guard_list.begin());
+      cached=true;
+    }
+
+    return cached_expr;
   }
   
   void guard_expr(exprt &dest) const;
 
   bool empty() const { return guard_list.empty(); }
   bool is_true() const { return empty(); } 
-  bool is_false() const;
+  bool is_false() const
+  {
+    return !guard_list.empty() && guard_list.back().is_false();
+  }
   
   void make_true()
   {
     guard_list.clear();
+    cached=false;
   }
   
   void make_false();
@@ -55,6 +76,8 @@ public:
   void swap(guardt &g)
   {
     guard_list.swap(g.guard_list);
+    cached_expr.swap(g.cached_expr);
+    std::swap(cached, g.cached);
   }
 
   friend std::ostream &operator << (std::ostream &out, const guardt &g);
@@ -66,7 +89,11 @@ public:
   
   void resize(size_type s)
   {
-    guard_list.resize(s);
+    if(s!=guard_list.size())
+    {
+      guard_list.resize(s);
+      cached=false;
+    }
   }
   
   const guard_listt &get_guard_list() const
@@ -75,7 +102,11 @@ public:
   }
 
 protected:
-  guard_listt guard_list;  
+  guard_listt guard_list;
+
+  // the conjunction of the guard_list, if cached is set
+  mutable exprt cached_expr;
+  mutable bool cached;
 };
 
 #define Forall_guard(it, guard_list) \
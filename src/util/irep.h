@@ -26,6 +26,10 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <map>
 #endif
 
+#ifdef HAVE_THREADS
+#include <atomic>
+#endif
+
 #ifdef USE_DSTRING
 #include "dstring.h"
 #endif
@@ -264,8 +268,13 @@ public:
     friend class irept;
 
     #ifdef SHARING
+    #ifdef HAVE_THREADS
+    // ireps may be shared between threads
+    std::atomic<unsigned> ref_count;
+    #else
     unsigned ref_count;
     #endif
+    #endif
 
     #ifdef USE_DSTRING
     dstring data;
@@ -314,6 +323,21 @@ public:
       #endif
     {
     }
+
+    #ifdef HAVE_THREADS
+    // atomics cannot be copied
+    dt(const dt &d):
+      ref_count(1),
+      data(d.data),
+      named_sub(d.named_sub),
+      comments(d.comments),
+      sub(d.sub)
+      #ifdef HASH_CODE
+      , hash_code(d.hash_code)
+      #endif
+    {
+    }
+    #endif
     #else
     dt()
       #ifdef HASH_CODE
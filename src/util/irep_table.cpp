@@ -0,0 +1,384 @@
+/*******************************************************************\
+
+Module: Tables of ireps for binary files
+
+\*******************************************************************/
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+
+#include "irep_table.h"
+
+/*******************************************************************\
+
+Function: put_word
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: little-endian, whatever the host is
+
+\*******************************************************************/
+
+static inline void put_word(std::ostream &out, std::size_t w)
+{
+  if(w>0xffffffffu)
+    throw "goto binary block exceeds 32-bit words";
+
+  char buffer[4];
+  buffer[0]=char(w&0xff);
+  buffer[1]=char((w>>8)&0xff);
+  buffer[2]=char((w>>16)&0xff);
+  buffer[3]=char((w>>24)&0xff);
+  out.write(buffer, 4);
+}
+
+/*******************************************************************\
+
+Function: irep_table_writert::irep_index
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: adds the irep to the table, after everything it
+          consists of, unless an equal one is there already
+
+\*******************************************************************/
+
+unsigned irep_table_writert::irep_index(const irept &src)
+{
+  std::size_t number=irep_numbering.number(src);
+
+  if(number<irep_indices.size() && irep_indices[number]!=~0u)
+    return irep_indices[number];
+
+  const irept::subt &sub=src.get_sub();
+  const irept::named_subt &named_sub=src.get_named_sub();
+  const irept::named_subt &comments=src.get_comments();
+
+  // the parts first
+  wordst record;
+  record.reserve(5+sub.size()+2*(named_sub.size()+comments.size()));
+
+  record.push_back(string_index(src.id()));
+
+  if(sub.size()<0xffff && named_sub.size()<0x100 && comments.size()<0x100)
+    record.push_back(
+      sub.size()|(named_sub.size()<<16)|(comments.size()<<24));
+  else
+  {
+    record.push_back(~0u);
+    record.push_back(sub.size());
+    record.push_back(named_sub.size());
+    record.push_back(comments.size());
+  }
+
+  forall_irep(it, sub)
+    record.push_back(irep_index(*it));
+
+  forall_named_irep(it, named_sub)
+  {
+    record.push_back(string_index(it->first));
+    record.push_back(irep_index(it->second));
+  }
+
+  forall_named_irep(it, comments)
+  {
+    record.push_back(string_index(it->first));
+    record.push_back(irep_index(it->second));
+  }
+
+  ireps.insert(ireps.end(), record.begin(), record.end());
+
+  if(number>=irep_indices.size())
+    irep_indices.resize(number+1, ~0u);
+
+  unsigned index=number_of_ireps++;
+  irep_indices[number]=index;
+
+  return index;
+}
+
+/*******************************************************************\
+
+Function: irep_table_writert::string_index
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+unsigned irep_table_writert::string_index(const irep_idt &src)
+{
+  std::pair<string_indicest::iterator, bool> entry=
+    string_indices.insert(
+      std::make_pair(src, unsigned(strings.size())));
+
+  if(!entry.second)
+    return entry.first->second;
+
+  unsigned index=entry.first->second;
+  strings.push_back(src);
+  string_bytes+=4+(src.size()+3)/4*4;
+
+  return index;
+}
+
+/*******************************************************************\
+
+Function: irep_table_writert::write
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void irep_table_writert::write(std::ostream &out) const
+{
+  std::size_t size=
+    4+string_bytes+
+    8+4*ireps.size()+
+    4+4*payload.size();
+
+  put_word(out, size);
+
+  put_word(out, strings.size());
+
+  for(std::vector<irep_idt>::const_iterator
+      it=strings.begin();
+      it!=strings.end();
+      it++)
+  {
+    const std::string &s=id2string(*it);
+    put_word(out, s.size());
+    out.write(s.data(), s.size());
+
+    static const char padding[4]={ 0, 0, 0, 0 };
+    out.write(padding, (4-s.size()%4)%4);
+  }
+
+  put_word(out, number_of_ireps);
+  put_word(out, ireps.size());
+
+  for(wordst::const_iterator it=ireps.begin(); it!=ireps.end(); it++)
+    put_word(out, *it);
+
+  put_word(out, payload.size());
+
+  for(wordst::const_iterator it=payload.begin(); it!=payload.end(); it++)
+    put_word(out, *it);
+}
+
+/*******************************************************************\
+
+Function: irep_table_writert::clear
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void irep_table_writert::clear()
+{
+  payload.clear();
+  ireps.clear();
+  number_of_ireps=0;
+  strings.clear();
+  string_bytes=0;
+  irep_indices.clear();
+  string_indices.clear();
+  irep_numbering.clear();
+}
+
+/*******************************************************************\
+
+Function: irep_table_readert::read
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void irep_table_readert::read(std::istream &in)
+{
+  unsigned char size_buffer[4];
+  in.read((char *)size_buffer, 4);
+
+  if(!in)
+    throw "goto binary block is truncated";
+
+  std::size_t size=get_word(size_buffer);
+
+  if(size<16)
+    throw "goto binary block is truncated";
+
+  // in chunks, so that a bad size fails once the input ends,
+  // not by allocating it all up front
+  const std::size_t chunk=1<<20;
+  buffer.clear();
+
+  while(buffer.size()<size)
+  {
+    std::size_t old_size=buffer.size();
+    buffer.resize(std::min(size, old_size+chunk));
+    in.read((char *)&buffer[old_size], buffer.size()-old_size);
+
+    if(!in)
+      throw "goto binary block is truncated";
+  }
+
+  const unsigned char *p=&buffer.front();
+  const unsigned char *end=p+size;
+
+  // strings
+  std::size_t number_of_strings=get_word(p);
+  p+=4;
+
+  // each takes a word at least
+  if(std::size_t(end-p)/4<number_of_strings)
+    throw "goto binary block is truncated";
+
+  strings.clear();
+  strings.reserve(number_of_strings);
+
+  for(std::size_t i=0; i<number_of_strings; i++)
+  {
+    if(end-p<4)
+      throw "goto binary block is truncated";
+
+    std::size_t length=get_word(p);
+    p+=4;
+
+    std::size_t padded=(length+3)/4*4;
+    if(std::size_t(end-p)<padded)
+      throw "goto binary block is truncated";
+
+    strings.push_back(irep_idt(std::string((const char *)p, length)));
+    p+=padded;
+  }
+
+  // ireps, each made of ones that are there already
+  if(end-p<8)
+    throw "goto binary block is truncated";
+
+  std::size_t number_of_ireps=get_word(p);
+  std::size_t irep_words=get_word(p+4);
+  p+=8;
+
+  if(std::size_t(end-p)/4<irep_words)
+    throw "goto binary block is truncated";
+
+  const unsigned char *ireps_end=p+4*irep_words;
+
+  // each takes two words at least
+  if(irep_words/2<number_of_ireps)
+    throw "goto binary block has bad irep table";
+
+  ireps.clear();
+  ireps.reserve(number_of_ireps);
+
+  while(p!=ireps_end)
+  {
+    if(ireps_end-p<8)
+      throw "goto binary block is truncated";
+
+    std::size_t id=get_word(p);
+    std::size_t sizes=get_word(p+4);
+    std::size_t sub_size, named_size, comments_size;
+    p+=8;
+
+    if(sizes!=0xffffffff)
+    {
+      sub_size=sizes&0xffff;
+      named_size=(sizes>>16)&0xff;
+      comments_size=sizes>>24;
+    }
+    else
+    {
+      if(ireps_end-p<12)
+        throw "goto binary block is truncated";
+
+      sub_size=get_word(p);
+      named_size=get_word(p+4);
+      comments_size=get_word(p+8);
+      p+=12;
+    }
+
+    if(std::size_t(ireps_end-p)/4<sub_size+2*(named_size+comments_size))
+      throw "goto binary block is truncated";
+
+    if(id>=strings.size())
+      throw "goto binary block has bad string index";
+
+    ireps.push_back(irept(strings[id]));
+    irept &irep=ireps.back();
+
+    irept::subt &sub=irep.get_sub();
+    sub.reserve(sub_size);
+
+    for(std::size_t i=0; i<sub_size; i++, p+=4)
+    {
+      std::size_t index=get_word(p);
+      if(index+1>=ireps.size())
+        throw "goto binary block has bad irep index";
+      sub.push_back(ireps[index]);
+    }
+
+    for(std::size_t c=0; c<2; c++)
+    {
+      irept::named_subt &named_sub=
+        c==0?irep.get_named_sub():irep.get_comments();
+
+      for(std::size_t i=0, s=c==0?named_size:comments_size;
+          i<s; i++, p+=8)
+      {
+        std::size_t name=get_word(p);
+        std::size_t index=get_word(p+4);
+
+        if(name>=strings.size())
+          throw "goto binary block has bad string index";
+        if(index+1>=ireps.size())
+          throw "goto binary block has bad irep index";
+
+        // written in order, hence at the end
+        #ifdef SUB_IS_LIST
+        named_sub.push_back(std::make_pair(strings[name], ireps[index]));
+        #else
+        named_sub.insert(
+          named_sub.end(), std::make_pair(strings[name], ireps[index]));
+        #endif
+      }
+    }
+  }
+
+  if(ireps.size()!=number_of_ireps)
+    throw "goto binary block has bad irep table";
+
+  // the payload
+  if(end-p<4)
+    throw "goto binary block is truncated";
+
+  std::size_t payload_words=get_word(p);
+  p+=4;
+
+  if(std::size_t(end-p)!=4*payload_words)
+    throw "goto binary block has bad payload";
+
+  next=p;
+  payload_end=end;
+}
@@ -0,0 +1,135 @@
+/*******************************************************************\
+
+Module: Tables of ireps for binary files
+
+\*******************************************************************/
+
+#ifndef CPROVER_IREP_TABLE_H
+#define CPROVER_IREP_TABLE_H
+
+#include <iosfwd>
+#include <vector>
+
+#include "irep_hash_container.h"
+#include "hash_cont.h"
+#include "irep.h"
+
+// A block of a binary file, made of a table of the strings, a table
+// of the ireps and a payload that refers to both by index.  All
+// numbers are 32-bit words, little-endian.  Every irep appears once,
+// up to full equality, and after the ireps it consists of, so that
+// reading a block is a single pass over memory, in which each irep
+// is put together from ireps that have already been read, sharing
+// them.  There are no variable-length numbers and no per-byte
+// stream access.
+//
+// Layout:
+//   number of bytes that follow
+//   number of strings, then for each: length, the characters,
+//     padded to a word
+//   number of ireps, number of words they take, then for each:
+//     id, the number of sub, named sub and comments in one word
+//     (16, 8 and 8 bits, or ~0 followed by a word for each), the
+//     sub, then name and irep for each named sub and comment
+//   number of payload words, then the payload
+
+class irep_table_writert
+{
+public:
+  irep_table_writert():number_of_ireps(0), string_bytes(0)
+  {
+  }
+
+  // the payload
+  inline void word(std::size_t w)
+  {
+    payload.push_back(w);
+  }
+
+  inline void irep(const irept &src)
+  {
+    payload.push_back(irep_index(src));
+  }
+
+  inline void string(const irep_idt &src)
+  {
+    payload.push_back(string_index(src));
+  }
+
+  void write(std::ostream &out) const;
+
+  void clear();
+
+protected:
+  typedef std::vector<unsigned> wordst;
+  wordst payload, ireps;
+  std::size_t number_of_ireps;
+
+  std::vector<irep_idt> strings;
+  std::size_t string_bytes;
+
+  // indexed by the number from the hash container
+  std::vector<unsigned> irep_indices;
+
+  typedef hash_map_cont<irep_idt, unsigned, irep_id_hash> string_indicest;
+  string_indicest string_indices;
+
+  irep_full_hash_containert irep_numbering;
+
+  unsigned irep_index(const irept &src);
+  unsigned string_index(const irep_idt &src);
+};
+
+class irep_table_readert
+{
+public:
+  // reads the block that starts at the current position
+  void read(std::istream &in);
+
+  // the payload, in the order it was written
+  inline bool eof() const
+  {
+    return next==payload_end;
+  }
+
+  std::size_t word()
+  {
+    if(next==payload_end)
+      throw "goto binary block is truncated";
+    std::size_t result=get_word(next);
+    next+=4;
+    return result;
+  }
+
+  const irept &irep()
+  {
+    std::size_t index=word();
+    if(index>=ireps.size())
+      throw "goto binary block has bad irep index";
+    return ireps[index];
+  }
+
+  const irep_idt &string()
+  {
+    std::size_t index=word();
+    if(index>=strings.size())
+      throw "goto binary block has bad string index";
+    return strings[index];
+  }
+
+  static inline std::size_t get_word(const unsigned char *p)
+  {
+    return std::size_t(p[0])|
+           (std::size_t(p[1])<<8)|
+           (std::size_t(p[2])<<16)|
+           (std::size_t(p[3])<<24);
+  }
+
+protected:
+  std::vector<unsigned char> buffer;
+  std::vector<irep_idt> strings;
+  std::vector<irept> ireps;
+  const unsigned char *next, *payload_end;
+};
+
+#endif
@@ -21,6 +21,9 @@ Author:
 #include <signal.h>
 #include <unistd.h>
 #include <string.h>
+#include <poll.h>
+#include <errno.h>
+#include <limits.h>
 #endif
 
 #define READ_BUFFER_SIZE 1024
@@ -42,7 +45,8 @@ pipe_stream::pipe_stream(
   const std::list<std::string> &_args):
   std::iostream(&buffer),
   executable(_executable),
-  args(_args)
+  args(_args),
+  capture_err(false)
 {
   #ifdef _WIN32
   pi.hProcess = 0;
@@ -143,11 +147,27 @@ int pipe_stream::run()
 
 int pipe_stream::run()
 {
-  filedescriptor_streambuf::HANDLE in[2], out[2];
+  filedescriptor_streambuf::HANDLE in[2], out[2], err[2];
 
-  if(pipe(in)==-1 || pipe(out)==-1)
+  if(pipe(in)==-1)
     return -1;
 
+  if(pipe(out)==-1)
+  {
+    close(in[0]);
+    close(in[1]);
+    return -1;
+  }
+
+  if(capture_err && pipe(err)==-1)
+  {
+    close(in[0]);
+    close(in[1]);
+    close(out[0]);
+    close(out[1]);
+    return -1;
+  }
+
   pid=fork();
     
   if(pid==0)
@@ -157,6 +177,15 @@ int pipe_stream::run()
     close(out[0]);
     dup2(in[0], STDIN_FILENO);
     dup2(out[1], STDOUT_FILENO);
+    close(in[0]);
+    close(out[1]);
+
+    if(capture_err)
+    {
+      close(err[0]);
+      dup2(err[1], STDERR_FILENO);
+      close(err[1]);
+    }
 
     char **_argv=new char * [args.size()+2];
     
@@ -172,16 +201,26 @@ int pipe_stream::run()
      
     _argv[args.size()+1]=NULL;
 
-    int result=execvp(executable.c_str(), _argv);
+    execvp(executable.c_str(), _argv);
 
-    if(result==-1)
-      perror(0);
-
-    return result;
+    // only get here on error
+    perror(0);
+    _exit(127);
   }
   else if(pid==-1)
   {
     // error on parent
+    close(in[0]);
+    close(in[1]);
+    close(out[0]);
+    close(out[1]);
+
+    if(capture_err)
+    {
+      close(err[0]);
+      close(err[1]);
+    }
+
     return -1;
   }
 
@@ -193,6 +232,12 @@ int pipe_stream::run()
   buffer.set_in(in[1]);
   buffer.set_out(out[0]);
 
+  if(capture_err)
+  {
+    close(err[1]);
+    buffer.set_err(err[0]);
+  }
+
   return pid;
 }
 
@@ -227,11 +272,17 @@ int pipe_stream::wait()
   if(pid<=0)
     return -1;
 
+  // the process may not terminate before its stderr is read
+  buffer.read_err();
+
   int result, status;
   result=waitpid(pid, &status, WUNTRACED);
   if(result<=0) 
     return -1;
 
+  if(!WIFEXITED(status))
+    return -1;
+
   return WEXITSTATUS(status);
   #endif
 }
@@ -251,10 +302,13 @@ Function: filedescriptor_streambuf::filedescriptor_streambuf
 filedescriptor_streambuf::filedescriptor_streambuf():
   #ifdef _WIN32
   proc_in(INVALID_HANDLE_VALUE),
-  proc_out(INVALID_HANDLE_VALUE)
+  proc_out(INVALID_HANDLE_VALUE),
+  proc_err(INVALID_HANDLE_VALUE)
   #else
   proc_in(STDOUT_FILENO),
-  proc_out(STDIN_FILENO)
+  proc_out(STDIN_FILENO),
+  proc_err(-1),
+  out_eof(false)
   #endif
 { 
   in_buffer=new char[READ_BUFFER_SIZE];
@@ -283,6 +337,9 @@ filedescriptor_streambuf::~filedescriptor_streambuf()
   if(proc_out!=INVALID_HANDLE_VALUE)
     CloseHandle(proc_out);
 
+  if(proc_err!=INVALID_HANDLE_VALUE)
+    CloseHandle(proc_err);
+
   #else
 
   if(proc_in!=STDOUT_FILENO)
@@ -291,6 +348,9 @@ filedescriptor_streambuf::~filedescriptor_streambuf()
   if(proc_out!=STDIN_FILENO)
     close(proc_out);
 
+  if(proc_err!=-1)
+    close(proc_err);
+
   #endif
   
   delete in_buffer;
@@ -298,6 +358,195 @@ filedescriptor_streambuf::~filedescriptor_streambuf()
 
 /*******************************************************************\
 
+Function: filedescriptor_streambuf::close_in
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: close the stdin of the piped process
+
+\*******************************************************************/
+
+void filedescriptor_streambuf::close_in()
+{
+  #ifdef _WIN32
+  if(proc_in!=INVALID_HANDLE_VALUE)
+    CloseHandle(proc_in);
+  proc_in=INVALID_HANDLE_VALUE;
+  #else
+  if(proc_in!=STDOUT_FILENO)
+    close(proc_in);
+  proc_in=STDOUT_FILENO;
+  #endif
+}
+
+/*******************************************************************\
+
+Function: filedescriptor_streambuf::read_err
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: read the stderr of the piped process until EOF
+
+\*******************************************************************/
+
+void filedescriptor_streambuf::read_err()
+{
+  #ifndef _WIN32
+  char buffer[READ_BUFFER_SIZE];
+
+  while(proc_err!=-1)
+  {
+    ssize_t len=read(proc_err, buffer, READ_BUFFER_SIZE);
+
+    if(len>0)
+      err_text.append(buffer, len);
+    else if(len==-1 && errno==EINTR)
+      continue;
+    else
+    {
+      close(proc_err);
+      proc_err=-1;
+    }
+  }
+  #endif
+}
+
+/*******************************************************************\
+
+Function: filedescriptor_streambuf::wait_for
+
+  Inputs: a descriptor and the poll events to wait for
+
+ Outputs: false if the descriptor has an error or has been
+          closed at the other end
+
+ Purpose: block until the descriptor is ready, meanwhile reading
+          what the process writes to stderr, and to stdout when
+          waiting for something else, so that it never blocks
+
+\*******************************************************************/
+
+#ifndef _WIN32
+
+bool filedescriptor_streambuf::wait_for(HANDLE fd, short events)
+{
+  bool read_out=fd!=proc_out && !out_eof && proc_out!=STDIN_FILENO;
+
+  if(proc_err==-1 && !read_out)
+    return true;
+
+  while(true)
+  {
+    pollfd fds[3];
+    nfds_t n=0;
+
+    fds[n].fd=fd;
+    fds[n].events=events;
+    n++;
+
+    if(proc_err!=-1)
+    {
+      fds[n].fd=proc_err;
+      fds[n].events=POLLIN;
+      n++;
+    }
+
+    if(read_out)
+    {
+      fds[n].fd=proc_out;
+      fds[n].events=POLLIN;
+      n++;
+    }
+
+    if(poll(fds, n, -1)==-1)
+    {
+      if(errno==EINTR)
+        continue;
+      return false;
+    }
+
+    for(nfds_t i=1; i<n; i++)
+    {
+      if(fds[i].revents==0)
+        continue;
+
+      char buffer[READ_BUFFER_SIZE];
+      ssize_t len=read(fds[i].fd, buffer, READ_BUFFER_SIZE);
+
+      if(len==-1 && errno==EINTR)
+        continue;
+
+      if(fds[i].fd==proc_err)
+      {
+        if(len>0)
+          err_text.append(buffer, len);
+        else
+        {
+          close(proc_err);
+          proc_err=-1;
+        }
+      }
+      else
+      {
+        if(len>0)
+          pending_out.append(buffer, len);
+        else
+        {
+          out_eof=true;
+          read_out=false;
+        }
+      }
+    }
+
+    if(fds[0].revents!=0)
+      return (fds[0].revents&(POLLERR|POLLHUP|POLLNVAL))==0 ||
+             (fds[0].revents&events)!=0;
+  }
+}
+
+#endif
+
+/*******************************************************************\
+
+   Class: ignore_sigpipet
+
+ Purpose: while it exists, writing to a pipe whose process has
+          terminated fails with EPIPE instead of raising SIGPIPE,
+          which would terminate us
+
+\*******************************************************************/
+
+#ifndef _WIN32
+
+class ignore_sigpipet
+{
+public:
+  ignore_sigpipet()
+  {
+    struct sigaction ignore;
+    memset(&ignore, 0, sizeof(ignore));
+    ignore.sa_handler=SIG_IGN;
+    sigemptyset(&ignore.sa_mask);
+    sigaction(SIGPIPE, &ignore, &old_action);
+  }
+
+  ~ignore_sigpipet()
+  {
+    sigaction(SIGPIPE, &old_action, NULL);
+  }
+
+protected:
+  struct sigaction old_action;
+};
+
+#endif
+
+/*******************************************************************\
+
 Function: filedescriptor_streambuf::overflow
 
   Inputs:
@@ -318,6 +567,9 @@ std::streambuf::int_type filedescriptor_streambuf::overflow(
     DWORD len;
     WriteFile(proc_in, &buf, 1, &len, NULL);
 #else
+    if(!wait_for(proc_in, POLLOUT))
+      return EOF;
+    ignore_sigpipet ignore_sigpipe;
     int len=write(proc_in, &buf, 1);
 #endif
     if(len!=1)
@@ -348,7 +600,36 @@ std::streamsize filedescriptor_streambuf::xsputn(
   WriteFile(proc_in, str, (DWORD)count, &len, NULL);
   return len;
 #else
-  return write(proc_in, str, count);
+  std::streamsize written=0;
+
+  // a process that has terminated gives EPIPE, and a short count
+  ignore_sigpipet ignore_sigpipe;
+
+  // at most PIPE_BUF at a time, which fits once the pipe is
+  // writable, so that we never block with the process waiting
+  // for us to read
+  while(written<count)
+  {
+    if(!wait_for(proc_in, POLLOUT))
+      break;
+
+    std::streamsize chunk=count-written;
+    if(chunk>PIPE_BUF)
+      chunk=PIPE_BUF;
+
+    ssize_t len=write(proc_in, str+written, chunk);
+
+    if(len==-1)
+    {
+      if(errno==EINTR)
+        continue;
+      break;
+    }
+
+    written+=len;
+  }
+
+  return written;
 #endif
 }
 
@@ -377,12 +658,28 @@ std::streambuf::int_type filedescriptor_streambuf::underflow()
   if(!ReadFile(proc_out, eback(), READ_BUFFER_SIZE, &len, NULL))
     return traits_type::eof();
   #else
-  ssize_t len=read(proc_out, eback(), READ_BUFFER_SIZE);
-  if (len==-1)
-    return traits_type::eof();
+  if(!pending_out.empty())
+  {
+    // what arrived while we were writing
+    out_buffer.swap(pending_out);
+    pending_out.clear();
+    char *p=&out_buffer[0];
+    setg(p, p, p+out_buffer.size());
+    return traits_type::to_int_type(*gptr());
+  }
+
+  ssize_t len=0;
+
+  if(!out_eof)
+  {
+    wait_for(proc_out, POLLIN);
+    len=read(proc_out, in_buffer, READ_BUFFER_SIZE);
+    if (len==-1)
+      return traits_type::eof();
+  }
   #endif
     
-  setg(eback(), eback(), eback()+(sizeof(char_type)*len));
+  setg(in_buffer, in_buffer, in_buffer+(sizeof(char_type)*len));
   
   if (len==0)
     return traits_type::eof();
@@ -34,13 +34,35 @@ public:
   // these are closed automatically on destruction
   void set_in(HANDLE in) { proc_in=in; }
   void set_out(HANDLE out) { proc_out=out; }
+  void set_err(HANDLE err) { proc_err=err; }
+
+  // the process gets EOF on its stdin
+  void close_in();
+
+  // What the process writes to a separate stderr pipe is collected
+  // whenever the stream waits for the process, and what it writes to
+  // stdout while we are waiting to write to it is kept for reading
+  // later, so that the process never blocks on either.
+  const std::string &get_err() const { return err_text; }
+
+  // collects stderr until EOF, once stdout has been read
+  void read_err();
 
   ~filedescriptor_streambuf();
   
 protected:
-  HANDLE proc_in, proc_out;
+  HANDLE proc_in, proc_out, proc_err;
   char *in_buffer;
 
+  std::string err_text;
+
+  #ifndef _WIN32
+  std::string pending_out, out_buffer;
+  bool out_eof;
+
+  bool wait_for(HANDLE fd, short events);
+  #endif
+
   int_type overflow(int_type);
   std::streamsize xsputn(const char *, std::streamsize);
   int_type underflow();
@@ -55,12 +77,25 @@ public:
     const std::string &_executable,
     const std::list<std::string> &_args);
 
+  // the stderr of the process goes to a pipe of its own, see
+  // stderr_text(); to be called before run(), and not available
+  // on Windows, where stderr goes with stdout
+  void capture_stderr() { capture_err=true; }
+
   int run();
   int wait();
 
+  void close_in() { buffer.close_in(); }
+
+  const std::string &stderr_text() const
+  {
+    return buffer.get_err();
+  }
+
 protected:
   std::string executable;
   std::list<std::string> args;
+  bool capture_err;
 
   #ifdef _WIN32
   PROCESS_INFORMATION pi;
@@ -0,0 +1,282 @@
+/*******************************************************************\
+
+Module: Maps with Structural Sharing
+
+\*******************************************************************/
+
+#ifndef CPROVER_SHARING_MAP_H
+#define CPROVER_SHARING_MAP_H
+
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "reference_counting.h"
+
+// A map that is split by the hash of the key into a fixed number
+// of shards.  Both the array of shards and each shard are reference
+// counted, so a copy of the map is a single pointer copy, and a write
+// only copies the shard the key lives in.  Two maps that have been
+// copied from each other share the shards nobody has written to,
+// which makes comparisons and merges skip them.
+//
+// Iterators are invalidated by any write to the map.  Within a shard,
+// the entries are ordered by the key; get_sorted gives all entries in
+// key order, for output that must not depend on the hash.
+
+template<typename keyT, typename valueT, typename hashT>
+class sharing_mapt
+{
+public:
+  typedef keyT key_type;
+  typedef valueT mapped_type;
+  typedef std::pair<const keyT, valueT> value_type;
+
+  static const std::size_t number_of_shards=32;
+
+  class shardt:public std::map<keyT, valueT>
+  {
+  public:
+    shardt() {}
+    const static shardt blank;
+  };
+
+  typedef typename shardt::const_iterator shard_const_iteratort;
+
+  class const_iterator
+  {
+  public:
+    inline const_iterator():shards(NULL), index(number_of_shards)
+    {
+    }
+
+    inline const_iterator(
+      const sharing_mapt &map,
+      std::size_t _index,
+      shard_const_iteratort _it):
+      shards(&map.data.read()), index(_index), it(_it)
+    {
+    }
+
+    inline const value_type &operator*() const
+    {
+      return *it;
+    }
+
+    inline const value_type *operator->() const
+    {
+      return &(*it);
+    }
+
+    inline const_iterator &operator++()
+    {
+      ++it;
+      skip_empty();
+      return *this;
+    }
+
+    inline const_iterator operator++(int)
+    {
+      const_iterator tmp=*this;
+      ++(*this);
+      return tmp;
+    }
+
+    inline bool operator==(const const_iterator &other) const
+    {
+      if(index!=other.index) return false;
+      return index==number_of_shards || it==other.it;
+    }
+
+    inline bool operator!=(const const_iterator &other) const
+    {
+      return !(*this==other);
+    }
+
+  protected:
+    friend class sharing_mapt;
+
+    const typename sharing_mapt::shardst *shards;
+    std::size_t index;
+    shard_const_iteratort it;
+
+    // moves on to the next shard that has entries
+    void skip_empty()
+    {
+      while(it==shards->shards[index].read().end())
+      {
+        index++;
+        if(index==number_of_shards) return;
+        it=shards->shards[index].read().begin();
+      }
+    }
+  };
+
+  inline sharing_mapt()
+  {
+  }
+
+  inline sharing_mapt(const sharing_mapt &other):data(other.data)
+  {
+  }
+
+  // reference_counting does not permit self-assignment
+  inline sharing_mapt &operator=(const sharing_mapt &other)
+  {
+    if(&other!=this) data=other.data;
+    return *this;
+  }
+
+  inline const_iterator begin() const
+  {
+    const_iterator result(*this, 0, read_shard(0).begin());
+    result.skip_empty();
+    return result;
+  }
+
+  inline const_iterator end() const
+  {
+    return const_iterator();
+  }
+
+  const_iterator find(const keyT &key) const
+  {
+    std::size_t index=shard_of(key);
+    const shardt &shard=read_shard(index);
+    shard_const_iteratort it=shard.find(key);
+    if(it==shard.end()) return end();
+    return const_iterator(*this, index, it);
+  }
+
+  inline bool empty() const
+  {
+    return begin()==end();
+  }
+
+  std::size_t size() const
+  {
+    std::size_t result=0;
+    for(std::size_t i=0; i<number_of_shards; i++)
+      result+=read_shard(i).size();
+    return result;
+  }
+
+  inline void clear()
+  {
+    data.clear();
+  }
+
+  inline void swap(sharing_mapt &other)
+  {
+    data.swap(other.data);
+  }
+
+  typedef std::vector<const value_type *> sorted_entriest;
+
+  // all entries in key order, as a std::map would have them
+  void get_sorted(sorted_entriest &dest) const
+  {
+    dest.clear();
+    for(const_iterator it=begin(); it!=end(); it++)
+      dest.push_back(&(*it));
+    std::sort(dest.begin(), dest.end(), key_lesst());
+  }
+
+  // returns the entry for 'key', which is 'value' if
+  // there was none before
+  valueT &insert(const keyT &key, const valueT &value)
+  {
+    shardt &shard=write_shard(shard_of(key));
+    return shard.insert(value_type(key, value)).first->second;
+  }
+
+  // returns NULL if there is no entry, and does
+  // not copy anything in that case
+  valueT *find_for_write(const keyT &key)
+  {
+    std::size_t index=shard_of(key);
+    if(read_shard(index).find(key)==read_shard(index).end())
+      return NULL;
+    return &write_shard(index).find(key)->second;
+  }
+
+  void erase(const keyT &key)
+  {
+    std::size_t index=shard_of(key);
+    if(read_shard(index).find(key)!=read_shard(index).end())
+      write_shard(index).erase(key);
+  }
+
+  // access by shard, for operations on two maps
+
+  static inline std::size_t shard_of(const keyT &key)
+  {
+    return hashT()(key)%number_of_shards;
+  }
+
+  inline const shardt &read_shard(std::size_t index) const
+  {
+    return data.read().shards[index].read();
+  }
+
+  inline shardt &write_shard(std::size_t index)
+  {
+    return data.write().shards[index].write();
+  }
+
+  // true if the shard is known to be the same in both maps
+  inline bool shares_shard(
+    const sharing_mapt &other,
+    std::size_t index) const
+  {
+    return data.read().shards[index].get_d()==
+           other.data.read().shards[index].get_d();
+  }
+
+  // true if the maps are known to be the same
+  inline bool shares_with(const sharing_mapt &other) const
+  {
+    return data.get_d()==other.data.get_d();
+  }
+
+  // makes the shard the same as in 'other', without copying it
+  inline void share_shard(
+    const sharing_mapt &other,
+    std::size_t index)
+  {
+    if(shares_shard(other, index)) return;
+    data.write().shards[index]=other.data.read().shards[index];
+  }
+
+protected:
+  typedef reference_counting<shardt> shard_reft;
+
+  struct key_lesst
+  {
+    bool operator()(const value_type *a, const value_type *b) const
+    {
+      return a->first<b->first;
+    }
+  };
+
+  class shardst
+  {
+  public:
+    shardst() {}
+    shard_reft shards[number_of_shards];
+    const static shardst blank;
+  };
+
+  reference_counting<shardst> data;
+};
+
+template<typename keyT, typename valueT, typename hashT>
+const typename sharing_mapt<keyT, valueT, hashT>::shardt
+  sharing_mapt<keyT, valueT, hashT>::shardt::blank;
+
+template<typename keyT, typename valueT, typename hashT>
+const typename sharing_mapt<keyT, valueT, hashT>::shardst
+  sharing_mapt<keyT, valueT, hashT>::shardst::blank;
+
+#endif
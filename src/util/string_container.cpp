@@ -6,6 +6,7 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
+#include <cassert>
 #include <string.h>
 
 #include "string_container.h"
@@ -63,6 +64,11 @@ void initialize_string_container();
 
 string_containert::string_containert()
 {
+  #ifdef HAVE_THREADS
+  for(std::size_t i=0; i<max_blocks; i++)
+    string_blocks[i].store(0, std::memory_order_relaxed);
+  #endif
+
   // pre-allocate empty string -- this gets index 0
   get("");
 
@@ -84,6 +90,10 @@ Function: string_containert::~string_containert
 
 string_containert::~string_containert()
 {
+  #ifdef HAVE_THREADS
+  for(std::size_t i=0; i<max_blocks; i++)
+    delete[] string_blocks[i].load(std::memory_order_relaxed);
+  #endif
 }
 
 /*******************************************************************\
@@ -102,23 +112,16 @@ unsigned string_containert::get(const char *s)
 {
   string_ptrt string_ptr(s);
 
+  #ifdef HAVE_THREADS
+  std::lock_guard<std::mutex> lock(mutex);
+  #endif
+
   hash_tablet::iterator it=hash_table.find(string_ptr);
   
   if(it!=hash_table.end())
     return it->second;
 
-  size_t r=hash_table.size();
-
-  // these are stable
-  string_list.push_back(std::string(s));
-  string_ptrt result(string_list.back());
-
-  hash_table[result]=r;
-  
-  // these are not
-  string_vector.push_back(&string_list.back());
-
-  return r;
+  return add(std::string(s));
 }
 
 /*******************************************************************\
@@ -137,21 +140,64 @@ unsigned string_containert::get(const std::string &s)
 {
   string_ptrt string_ptr(s);
 
+  #ifdef HAVE_THREADS
+  std::lock_guard<std::mutex> lock(mutex);
+  #endif
+
   hash_tablet::iterator it=hash_table.find(string_ptr);
   
   if(it!=hash_table.end())
     return it->second;
 
+  return add(s);
+}
+
+/*******************************************************************\
+
+Function: string_containert::add
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: stores a string that is not yet in the container
+
+\*******************************************************************/
+
+unsigned string_containert::add(const std::string &s)
+{
   size_t r=hash_table.size();
 
   // these are stable
   string_list.push_back(s);
   string_ptrt result(string_list.back());
 
-  hash_table[result]=r;
-  
+  #ifdef HAVE_THREADS
+  std::size_t block=r>>block_bits;
+  assert(block<max_blocks);
+
+  // only this thread, holding the lock, writes the blocks
+  const std::string **block_ptr=
+    string_blocks[block].load(std::memory_order_relaxed);
+
+  if(block_ptr==0)
+  {
+    block_ptr=new const std::string *[block_size];
+    block_ptr[r&(block_size-1)]=&string_list.back();
+    string_blocks[block].store(block_ptr, std::memory_order_release);
+  }
+  else
+  {
+    // the number is only handed out after this, under the lock,
+    // or through whatever the ireps that hold it are passed with
+    block_ptr[r&(block_size-1)]=&string_list.back();
+  }
+  #else
   // these are not
   string_vector.push_back(&string_list.back());
+  #endif
+
+  hash_table[result]=r;
 
   return r;
 }
@@ -12,6 +12,11 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <list>
 #include <vector>
 
+#ifdef HAVE_THREADS
+#include <atomic>
+#include <mutex>
+#endif
+
 #include "hash_cont.h"
 #include "string_hash.h"
 
@@ -62,13 +67,13 @@ public:
   // the pointer is guaranteed to be stable  
   inline const char *c_str(size_t no) const
   {
-    return string_vector[no]->c_str();
+    return get_pointer(no)->c_str();
   }
   
   // the reference is guaranteed to be stable
   inline const std::string &get_string(size_t no) const
   {
-    return *string_vector[no];
+    return *get_pointer(no);
   }
   
 protected:
@@ -78,12 +83,37 @@ protected:
   
   unsigned get(const char *s);
   unsigned get(const std::string &s);
+  unsigned add(const std::string &s);
   
   typedef std::list<std::string> string_listt;
   string_listt string_list;
   
+  #ifdef HAVE_THREADS
+  // Looking up the number of a string and adding strings take
+  // the lock, looking up a string by number does not: the pointers
+  // are kept in blocks that never move, the table of blocks is
+  // allocated up front, and a new block is published with release
+  // semantics once it is filled in.
+  std::mutex mutex;
+
+  enum { block_bits=16, block_size=1<<block_bits, max_blocks=1<<12 };
+  std::atomic<const std::string **> string_blocks[max_blocks];
+
+  inline const std::string *get_pointer(size_t no) const
+  {
+    const std::string **block=
+      string_blocks[no>>block_bits].load(std::memory_order_acquire);
+    return block[no&(block_size-1)];
+  }
+  #else
   typedef std::vector<std::string *> string_vectort;
   string_vectort string_vector;
+
+  inline const std::string *get_pointer(size_t no) const
+  {
+    return string_vector[no];
+  }
+  #endif
 };
 
 // an ugly global object